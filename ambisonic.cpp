@@ -0,0 +1,244 @@
+// Ambisonic bus render mode – see ambisonic.h
+// -------------------------------------------------------------------
+// • Per emitter sample: (order + 1)² ramped multiply-adds into the bus.
+// • Per partition: (order + 1)² forward FFTs, the SH-domain filter
+//   products and two inverse FFTs, whatever the emitter count.
+
+#include "ambisonic.h"
+
+void ambiEncodeGains(float x, float y, float z, int order, float* g)
+{
+    g[0] = 1.0f;
+    if (order < 1)
+        return;
+
+    const float s3 = 1.7320508f;                       // √3
+    g[1] = s3 * y;
+    g[2] = s3 * z;
+    g[3] = s3 * x;
+    if (order < 2)
+        return;
+
+    const float s15 = 3.8729833f;                      // √15
+    g[4] = s15 * x * y;
+    g[5] = s15 * y * z;
+    g[6] = 1.1180340f * (3.0f * z * z - 1.0f);          // √5 / 2
+    g[7] = s15 * x * z;
+    g[8] = 0.5f * s15 * (x * x - y * y);
+    if (order < 3)
+        return;
+
+    const float c35 = 2.0916500f;                      // √(35/8)
+    const float c21 = 1.6201852f;                      // √(21/8)
+    const float s105 = 10.2469508f;                    // √105
+    g[9]  = c35 * y * (3.0f * x * x - y * y);
+    g[10] = s105 * x * y * z;
+    g[11] = c21 * y * (5.0f * z * z - 1.0f);
+    g[12] = 1.3228757f * z * (5.0f * z * z - 3.0f);      // √7 / 2
+    g[13] = c21 * x * (5.0f * z * z - 1.0f);
+    g[14] = 0.5f * s105 * z * (x * x - y * y);
+    g[15] = c35 * x * (x * x - 3.0f * y * y);
+}
+
+// ────────────────────────────────────────────────────────────────
+// Filter construction
+// ────────────────────────────────────────────────────────────────
+// out[t] = in[t − d] with 4-point Lagrange interpolation; in is zero
+// outside [0, kHrirLength)
+static void delayIr(const float* in, float* out, float d)
+{
+    for (int t = 0; t < kHrirLength; ++t) {
+        float p = static_cast<float>(t) - d;
+        float i = floorf(p);
+        float f = p - i;
+        float h[4] = {
+            -f * (f - 1.0f) * (f - 2.0f) * (1.0f / 6.0f),
+            (f + 1.0f) * (f - 1.0f) * (f - 2.0f) * 0.5f,
+            -(f + 1.0f) * f * (f - 2.0f) * 0.5f,
+            (f + 1.0f) * f * (f - 1.0f) * (1.0f / 6.0f),
+        };
+        float y = 0.0f;
+        for (int k = 0; k < 4; ++k) {
+            int j = static_cast<int>(i) - 1 + k;
+            if (j >= 0 && j < kHrirLength)
+                y += h[k] * in[j];
+        }
+        out[t] = y;
+    }
+}
+
+static inline int ambiClampOrder(int order)
+{
+    return (order < 1) ? 1 : (order > kAmbiMaxOrder) ? kAmbiMaxOrder : order;
+}
+
+uint32_t AmbiDecoder::storageFloats(int order_)
+{
+    constexpr uint32_t kSpectra = kHrirPartitions * kHrirBins;
+    return ambiChannels(ambiClampOrder(order_)) * (kHrirFftSize + 2 * kSpectra + 4 * kSpectra);
+}
+
+void AmbiDecoder::init(int order_, float* storage, HrirRenderer* r)
+{
+    order    = ambiClampOrder(order_);
+    channels = ambiChannels(order);
+
+    inHist = reinterpret_cast<float (*)[kHrirFftSize]>(storage);
+    fdlRe  = reinterpret_cast<float (*)[kHrirPartitions][kHrirBins]>(inHist + channels);
+    fdlIm  = fdlRe + channels;
+    filtRe = reinterpret_cast<float (*)[2][kHrirPartitions][kHrirBins]>(fdlIm + channels);
+    filtIm = filtRe + channels;
+
+    const HrtfDataset& ds  = r->dataset;
+    const int          len = ds.irLength();
+    float* ir      = r->work.frame + kHrirFftSize;      // decoded HRIR
+    float* delayed = ir + kHrirLength;                  // with its ITD
+    float  gains[kAmbiMaxChannels];
+
+    // Sampling decode: every grid point is a virtual speaker weighted by
+    // the area of its share of its elevation band (the outer bands extend
+    // to the poles), so F_ch = Σ_p w_p/4π · Y_ch(p) · HRIR_p.  inHist
+    // doubles as the time-domain accumulator, one ear at a time.
+    for (int ear = 0; ear < 2; ++ear) {
+        memset(inHist, 0, channels * sizeof(*inHist));
+
+        for (int ring = 0; ring < ds.numRings(); ++ring) {
+            const HrtfRing& rg = ds.ring(ring);
+            float lo = (ring == 0) ? -90.0f
+                     : 0.5f * (ds.ring(ring - 1).elevation + rg.elevation);
+            float hi = (ring == ds.numRings() - 1) ? 90.0f
+                     : 0.5f * (ds.ring(ring + 1).elevation + rg.elevation);
+            float w  = (sinf(hi * (M_PI / 180.0f)) - sinf(lo * (M_PI / 180.0f)))
+                     / (2.0f * rg.numAz);
+
+            float el = rg.elevation * (M_PI / 180.0f);
+            for (int k = 0; k < rg.numAz; ++k) {
+                int   point = rg.firstPoint + k;
+                float az    = k * (2.0f * M_PI / rg.numAz);
+                ambiEncodeGains(cosf(el) * cosf(az), cosf(el) * sinf(az), sinf(el),
+                                order, gains);
+
+                ds.decode(point, ear, ir);
+                memset(ir + len, 0, (kHrirLength - len) * sizeof(float));
+                float itd = ds.itd(point);                       // > 0 → right ear lags
+                float lag = (ear == 0) ? (itd < 0.0f ? -itd : 0.0f)
+                                       : (itd > 0.0f ?  itd : 0.0f);
+                delayIr(ir, delayed, lag);
+
+                for (int ch = 0; ch < channels; ++ch) {
+                    float c = w * gains[ch];
+                    for (int t = 0; t < kHrirLength; ++t)
+                        inHist[ch][t] += c * delayed[t];
+                }
+            }
+        }
+
+        for (int ch = 0; ch < channels; ++ch) {
+            for (int k = 0; k < kHrirPartitions; ++k) {
+                memcpy(r->work.frame, inHist[ch] + k * kHrirPartition, kHrirPartition * sizeof(float));
+                memset(r->work.frame + kHrirPartition, 0, kHrirPartition * sizeof(float));
+                r->work.fft.forward(r->work.frame, filtRe[ch][ear][k], filtIm[ch][ear][k]);
+            }
+        }
+    }
+
+    clear();
+}
+
+void AmbiDecoder::clear()
+{
+    memset(inHist, 0, channels * sizeof(*inHist));
+    memset(fdlRe, 0, channels * sizeof(*fdlRe));
+    memset(fdlIm, 0, channels * sizeof(*fdlIm));
+    memset(outL, 0, sizeof(outL));
+    memset(outR, 0, sizeof(outR));
+    fdlHead = fill = 0;
+}
+
+// ────────────────────────────────────────────────────────────────
+// Partitioned convolution
+// ────────────────────────────────────────────────────────────────
+static void processPartition(AmbiDecoder* d, HrirRenderer* r)
+{
+    for (int ch = 0; ch < d->channels; ++ch) {
+        r->work.fft.forward(d->inHist[ch], d->fdlRe[ch][d->fdlHead], d->fdlIm[ch][d->fdlHead]);
+        memcpy(d->inHist[ch], d->inHist[ch] + kHrirPartition, kHrirPartition * sizeof(float));
+        memset(d->inHist[ch] + kHrirPartition, 0, kHrirPartition * sizeof(float));
+    }
+
+    float* out[2] = { d->outL, d->outR };
+    float* accRe  = r->work.re;
+    float* accIm  = r->work.im;
+    for (int ear = 0; ear < 2; ++ear) {
+        memset(accRe, 0, kHrirBins * sizeof(float));
+        memset(accIm, 0, kHrirBins * sizeof(float));
+
+        // Σ_ch Σ_k X_ch[head−k]·F_ch[k]
+        for (int ch = 0; ch < d->channels; ++ch) {
+            for (int k = 0; k < kHrirPartitions; ++k) {
+                int          slot = (d->fdlHead - k + kHrirPartitions) % kHrirPartitions;
+                const float* xr   = d->fdlRe[ch][slot];
+                const float* xi   = d->fdlIm[ch][slot];
+                const float* hr   = d->filtRe[ch][ear][k];
+                const float* hi   = d->filtIm[ch][ear][k];
+                for (int b = 0; b < kHrirBins; ++b) {
+                    accRe[b] += xr[b] * hr[b] - xi[b] * hi[b];
+                    accIm[b] += xr[b] * hi[b] + xi[b] * hr[b];
+                }
+            }
+        }
+        r->work.fft.inverse(accRe, accIm, r->work.frame);
+        memcpy(out[ear], r->work.frame + kHrirPartition, kHrirPartition * sizeof(float));
+    }
+
+    d->fdlHead = (d->fdlHead + 1) % kHrirPartitions;
+}
+
+// ────────────────────────────────────────────────────────────────
+// Public API
+// ────────────────────────────────────────────────────────────────
+void ambiEncodeMix(const float* in,
+                   int          numSamples,
+                   int          offset,
+                   int          rampLength,
+                   const float* gainStart,
+                   const float* gainEnd,
+                   AmbiDecoder* decoder)
+{
+    const float invLength = 1.0f / rampLength;
+    for (int ch = 0; ch < decoder->channels; ++ch) {
+        float  step = (gainEnd[ch] - gainStart[ch]) * invLength;
+        float  g    = gainStart[ch] + step * offset;
+        float* bus  = decoder->input(ch);
+        for (int n = 0; n < numSamples; ++n) {
+            g += step;
+            bus[n] += g * in[n];
+        }
+    }
+}
+
+void ambiDecodeMix(float* outL,
+                   float* outR,
+                   int    numSamples,
+                   bool   overwrite,
+                   AmbiDecoder* decoder,
+                   HrirRenderer* renderer)
+{
+    const float* yl = decoder->outL + decoder->fill;
+    const float* yr = decoder->outR + decoder->fill;
+    if (overwrite) {
+        memcpy(outL, yl, numSamples * sizeof(float));
+        memcpy(outR, yr, numSamples * sizeof(float));
+    } else {
+        for (int n = 0; n < numSamples; ++n) {
+            outL[n] += yl[n];
+            outR[n] += yr[n];
+        }
+    }
+
+    decoder->fill += numSamples;
+    if (decoder->fill == kHrirPartition) {
+        processPartition(decoder, renderer);
+        decoder->fill = 0;
+    }
+}
@@ -0,0 +1,94 @@
+// Ambisonic bus render mode
+// -------------------------------------------------------------------
+// • Emitters are encoded into a shared 1st…3rd-order Ambisonic bus
+//   (ACN channel order, N3D normalisation) with per-channel gain ramps:
+//   (order + 1)² multiply-adds per emitter sample, nothing else.
+// • One binaural decoder per instance runs on the bus: each Ambisonic
+//   channel is convolved with a left/right SH-domain HRTF filter pair
+//   and summed.  The filters are built once from the HRIR renderer's
+//   dataset by a sampling decode over its grid (virtual speaker per
+//   grid point, quadrature-weighted), with each point's ITD baked into
+//   its HRIRs.
+// • The decoder shares HrirRenderer's FFT and partitioning, so latency
+//   is one partition, as in HRIR mode.  Emitters write straight into
+//   the decoder's partition input; there is no separate bus buffer.
+// • Its per-channel histories and filters live in storage bound at
+//   init, sized for the bus order (storageFloats), not the maximum.
+
+#pragma once
+
+#include "hrir_renderer.h"
+
+constexpr int kAmbiMaxOrder    = 3;
+constexpr int kAmbiMaxChannels = (kAmbiMaxOrder + 1) * (kAmbiMaxOrder + 1);
+
+static inline int ambiChannels(int order)
+{
+    return (order + 1) * (order + 1);
+}
+
+// Real N3D spherical harmonics in ACN order for a unit direction
+// (x front, y left, z up); fills ambiChannels(order) gains.
+void ambiEncodeGains(float x, float y, float z, int order, float* gains);
+
+// ────────────────────────────────────────────────────────────────
+// Binaural decoder
+// ────────────────────────────────────────────────────────────────
+struct AmbiDecoder {
+    // Per channel, in storage: [channels][…]
+    float (*inHist)[kHrirFftSize] = nullptr;                // overlap-save input frames
+    float (*fdlRe)[kHrirPartitions][kHrirBins] = nullptr;
+    float (*fdlIm)[kHrirPartitions][kHrirBins] = nullptr;
+    float (*filtRe)[2][kHrirPartitions][kHrirBins] = nullptr;   // [ch][ear][partition][bin]
+    float (*filtIm)[2][kHrirPartitions][kHrirBins] = nullptr;
+    float outL[kHrirPartition], outR[kHrirPartition];
+
+    int order;
+    int channels;
+    int fdlHead;
+    int fill;             // samples in the current partition
+
+    // Floats of storage for a bus of `order` (clamped to 1…kAmbiMaxOrder)
+    static uint32_t storageFloats(int order);
+
+    // Binds storage (storageFloats(order)), builds the SH-domain filters
+    // for `order` from renderer->dataset (construct time: a few hundred
+    // HRIR decodes) and clears the bus.
+    void init(int order, float* storage, HrirRenderer* renderer);
+    void clear();
+
+    // Bus input for channel ch at the current fill position
+    float* input(int ch) { return inHist[ch] + kHrirPartition + fill; }
+};
+
+// ────────────────────────────────────────────────────────────────
+// Public API
+// ────────────────────────────────────────────────────────────────
+// Adds in[0…numSamples) into the bus with per-channel gains ramping
+// linearly from gainStart toward gainEnd over rampLength samples, the
+// first `offset` of which were rendered by earlier calls.  numSamples
+// must not cross a partition boundary (see ambiSegment()).
+void ambiEncodeMix(const float* in,
+                   int          numSamples,
+                   int          offset,
+                   int          rampLength,
+                   const float* gainStart,
+                   const float* gainEnd,
+                   AmbiDecoder* decoder);
+
+// Samples that can be encoded before the decoder must run
+static inline int ambiSegment(const AmbiDecoder* decoder, int remaining)
+{
+    int space = kHrirPartition - decoder->fill;
+    return (remaining < space) ? remaining : space;
+}
+
+// Writes (overwrite) or adds the decoded output for the samples encoded
+// since the last call, then advances the bus by numSamples, running the
+// convolution when a partition completes.
+void ambiDecodeMix(float* outL,
+                   float* outR,
+                   int    numSamples,
+                   bool   overwrite,
+                   AmbiDecoder* decoder,
+                   HrirRenderer* renderer);
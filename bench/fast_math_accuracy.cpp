@@ -0,0 +1,112 @@
+// Exhaustive accuracy check for fast_math.h
+// -------------------------------------------------------------------
+// Evaluates every approximation at every float in its documented
+// domain against the double-precision libm result and reports the
+// worst error and where it occurs.  Exits non-zero when any function
+// exceeds its bound, so the documented table in fast_math.h stays true.
+//
+//   fast_math_accuracy              every float (≈7 minutes on x86-64)
+//   fast_math_accuracy --stride N   every Nth float, for quick checks
+
+#include "fast_math.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+enum ErrorKind { kAbsolute, kRelative, kExact };
+
+struct Check {
+    const char* name;
+    float       lo, hi;          // domain, inclusive
+    ErrorKind   kind;
+    double      bound;
+    float (*fast)(float);
+    double (*reference)(double);
+};
+
+double refSin(double x)   { return sin(x); }
+double refCos(double x)   { return cos(x); }
+double refAsin(double x)  { return asin(x); }
+double refSqrt(double x)  { return static_cast<double>(sqrtf(static_cast<float>(x))); }
+double refExp2(double x)  { return exp2(x); }
+double refPow10(double x) { return pow(10.0, x); }
+double refDb(double x)    { return pow(10.0, x / 20.0); }
+
+const Check kChecks[] = {
+    { "fastSin",      -4.0f * 3.1415927f, 4.0f * 3.1415927f, kAbsolute, 2.5e-7, fastSin,      refSin   },
+    { "fastCos",      -4.0f * 3.1415927f, 4.0f * 3.1415927f, kAbsolute, 2.5e-7, fastCos,      refCos   },
+    { "fastAsin",     -1.0f,              1.0f,              kAbsolute, 3.0e-7, fastAsin,     refAsin  },
+    { "fastSqrt",      0.0f,              3.4e38f,           kExact,    0.0,    fastSqrt,     refSqrt  },
+    { "fastExp2",     -126.0f,            127.0f,            kRelative, 3.0e-7, fastExp2,     refExp2  },
+    { "fastPow10",    -30.0f,             30.0f,             kRelative, 3.0e-7, fastPow10,    refPow10 },
+    { "fastDbToGain", -120.0f,            120.0f,            kRelative, 3.0e-7, fastDbToGain, refDb    },
+};
+
+// Floats ordered as integers: negative values map below positive ones,
+// so [lo, hi] is one contiguous key range
+int64_t floatKey(float x)
+{
+    int32_t i;
+    memcpy(&i, &x, sizeof(i));
+    return (i < 0) ? -static_cast<int64_t>(i & 0x7fffffff) : i;
+}
+
+float keyFloat(int64_t k)
+{
+    int32_t i = (k < 0) ? static_cast<int32_t>(-k) | static_cast<int32_t>(0x80000000u)
+                        : static_cast<int32_t>(k);
+    float x;
+    memcpy(&x, &i, sizeof(x));
+    return x;
+}
+
+bool run(const Check& c, int64_t stride)
+{
+    double worst = 0.0;
+    float  worstAt = c.lo;
+    const int64_t last = floatKey(c.hi);
+    for (int64_t k = floatKey(c.lo); k <= last; k += stride) {
+        float  x   = keyFloat(k);
+        double ref = c.reference(x);
+        double y   = c.fast(x);
+        double err = fabs(y - ref);
+        if (c.kind == kRelative)
+            err /= fabs(ref);
+        if (err > worst || err != err) {
+            worst   = err;
+            worstAt = x;
+        }
+    }
+
+    bool ok = worst <= c.bound;
+    printf("%-13s [%10.4g, %10.4g]  max %s error %.3g at %.9g (bound %.3g)  %s\n",
+           c.name, c.lo, c.hi, c.kind == kRelative ? "rel" : "abs", worst, worstAt, c.bound,
+           ok ? "ok" : "FAIL");
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int64_t stride = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--stride") == 0 && i + 1 < argc) {
+            stride = atoll(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--stride N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (stride < 1)
+        stride = 1;
+
+    bool ok = true;
+    for (const Check& c : kChecks)
+        ok &= run(c, stride);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,804 @@
+// Tin Ear host benchmark suite
+// -------------------------------------------------------------------
+// • Times applyMonoSpatialAudio on its own and the full plugin step()
+//   through the factory, exactly as the module would drive it.
+// • Sweeps emitter count, block size and motion pattern; reports
+//   ns/sample per emitter and writes a stable-keyed JSON summary that
+//   a later run can be compared against (--compare).
+//
+//   build/host/tinear_bench [--quick] [--seconds S] [--filter TEXT]
+//                           [--rate HZ]
+//                           [--spec NAME=VALUE] [--param NAME=VALUE]
+//                           [--json OUT] [--compare BASELINE]
+//                           [--threshold PCT] [--draw]
+//
+//   --draw prints each step configuration's draw() text after it is
+//   measured; with make PROFILE=1 that is the stage load meter.
+
+#include "nt_host.h"
+#include "professional_spatial_audio.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace {
+
+// ────────────────────────────────────────────────────────────────
+// Configuration
+// ────────────────────────────────────────────────────────────────
+struct BenchOptions {
+    double      seconds   = 1.0;    // audio rendered per measurement
+    int         repeats   = 3;      // best-of
+    bool        quick     = false;
+    bool        draw      = false;  // print draw() text after each step run
+    double      threshold = 10.0;   // % slowdown that fails --compare
+    int         rate      = 48000;  // NT_globals.sampleRate for the run
+    std::string filter;
+    std::string jsonPath;
+    std::string comparePath;
+    std::vector<std::pair<std::string, int>> specOverrides;   // besides "Emitters"
+    std::vector<std::pair<std::string, int>> paramOverrides;  // by parameter name
+};
+
+// Largest block swept; above the 256-frame scratch size the engine
+// originally processed in, to catch any per-chunk overhead.
+constexpr int kMaxBenchFrames = 512;
+
+const int kBlockSizesBy4[] = { 1, 4, 8, 16, 32, 64, 128 };   // 4…512 frames
+const int kEmitterCounts[] = { 1, 2, 3, 4, 5, 6, 7, 8, 16, 32 };
+
+// Plugin configurations swept by benchStep: result-name prefix plus
+// parameter values (by name) applied after construction; idleOdd routes
+// every odd-numbered emitter to a silent bus to measure idle skipping,
+// cv gives every emitter it can Azimuth and Distance CV from a noise
+// bus (the decimated control path at its busiest), speakers sets the
+// Speakers specification (their default ring on busses 13 up), and head
+// sends a head tracker's yaw and pitch over MIDI before every block.
+struct ParamSetting {
+    const char* name;
+    int         value;
+};
+
+struct StepVariant {
+    const char*  prefix;
+    ParamSetting params[4];
+    bool         idleOdd;
+    bool         cv;
+    int          speakers;
+    bool         head;
+};
+
+const StepVariant kStepVariants[] = {
+    { "step",       {} },
+    { "step-lanes", { { "Engine", 1 } } },
+    { "step-hrir",  { { "Render mode", 1 } } },
+    { "step-lagrange", { { "Delay interp", 1 } } },
+    { "step-thiran",   { { "Delay interp", 2 } } },
+    { "step-ambi",     { { "Render mode", 2 } } },
+    { "step-idle",     {}, true },
+    { "step-lod",      { { "CPU budget", 4 } } },
+    { "step-reverb",   { { "Reverb", -12 } } },
+    { "step-svf",      { { "Filter", 1 } } },
+    { "step-cv",       {}, false, true },
+    { "step-cv8",      { { "CV interval", 8 } }, false, true },
+    { "step-speakers", { { "Render mode", 3 } }, false, false, 8 },
+    { "step-head",     { { "Head MIDI ch", 1 } }, false, false, 0, true },
+};
+
+constexpr int kCvBus = 12;
+
+constexpr int kSilentBus = 21;
+
+enum Motion { kMotionStatic, kMotionOrbit, kMotionJumps, kNumMotions };
+const char* const kMotionNames[kNumMotions] = { "static", "orbit", "jumps" };
+
+struct BenchResult {
+    std::string name;
+    int         emitters;
+    int         frames;
+    const char* motion;
+    double      nsPerSampleEmitter;
+    double      nsPerBlock;
+    double      cpuPercent;          // of one real-time stream at --rate
+};
+
+// ────────────────────────────────────────────────────────────────
+// Helpers
+// ────────────────────────────────────────────────────────────────
+using Clock = std::chrono::steady_clock;
+
+static double elapsedNs(Clock::time_point t0, Clock::time_point t1)
+{
+    return std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+static void fillNoise(float* dst, int n, uint32_t& seed, float amp)
+{
+    for (int i = 0; i < n; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        dst[i] = amp * (static_cast<int32_t>(seed) * (1.0f / 2147483648.0f));
+    }
+}
+
+// Motion pattern as azimuth/elevation in degrees for a given block.
+static void motionAngles(Motion m, int emitter, int numEmitters, long block,
+                         double blockSeconds, int& azDeg, int& elDeg)
+{
+    const int base = (numEmitters > 1) ? -90 + emitter * 180 / (numEmitters - 1) : 0;
+    switch (m) {
+        case kMotionStatic:
+            azDeg = base;
+            elDeg = 0;
+            break;
+        case kMotionOrbit: {                      // 45°/s, gentle bob
+            double t = block * blockSeconds;
+            azDeg    = static_cast<int>(base + 45.0 * t) % 360;
+            if (azDeg > 180) azDeg -= 360;
+            elDeg    = static_cast<int>(20.0 * ((static_cast<long>(t) & 1) ? 1 : -1));
+            break;
+        }
+        default: {                                // new position every block
+            long k = block * 7 + emitter * 3;
+            azDeg  = static_cast<int>((k * 137) % 361) - 180;
+            elDeg  = static_cast<int>((k * 71) % 181) - 90;
+            break;
+        }
+    }
+}
+
+static bool matches(const BenchOptions& o, const std::string& name)
+{
+    return o.filter.empty() || name.find(o.filter) != std::string::npos;
+}
+
+static void report(std::vector<BenchResult>& results, BenchResult r)
+{
+    printf("%-36s %10.2f ns/smp/em %12.0f ns/block %7.3f %%\n",
+           r.name.c_str(), r.nsPerSampleEmitter, r.nsPerBlock, r.cpuPercent);
+    fflush(stdout);
+    results.push_back(r);
+}
+
+// ────────────────────────────────────────────────────────────────
+// Kernel benchmark – applyMonoSpatialAudio in isolation
+// ────────────────────────────────────────────────────────────────
+struct KernelVariant {
+    const char* prefix;
+    int         tablePoints;     // 0 = exact trig builders
+    bool        fused;           // applyMonoSpatialAudioMix, accumulating
+    bool        quick;           // part of --quick
+    SpatialFilter filter;
+    SpatialKernel kernel;
+    SpatialQuality quality;
+};
+
+const KernelVariant kKernelVariants[] = {
+    { "kernel",         0,  false, true  },
+    { "kernel-table17", 17, false, false },
+    { "kernel-table33", 33, false, false },
+    { "kernel-table65", 65, false, true  },
+    { "kernel-mix",     65, true,  true  },
+    { "kernel-svf",     0,  false, true,  kFilterSvf },
+    { "kernel-2pass",   0,  false, true,  kFilterBiquad, kKernelTwoPass },
+    { "kernel-2pass-table65", 65, false, true, kFilterBiquad, kKernelTwoPass },
+    { "kernel-2pass-svf", 0, false, true, kFilterSvf, kKernelTwoPass },
+    { "kernel-2pass-nonotch", 0, false, true, kFilterBiquad, kKernelTwoPass, kQualityNoNotch },
+    { "kernel-2pass-direct",  0, false, true, kFilterBiquad, kKernelTwoPass, kQualityDirect },
+};
+
+static void benchKernel(const BenchOptions& o, std::vector<BenchResult>& results)
+{
+    const int sizes[] = { 16, 64, 256 };
+
+    for (const KernelVariant& v : kKernelVariants)
+    for (int frames : sizes) {
+        for (int m = 0; m < kNumMotions; ++m) {
+            char name[64];
+            snprintf(name, sizeof(name), "%s/f%d/%s", v.prefix, frames, kMotionNames[m]);
+            if (!matches(o, name) || (o.quick && !v.quick))
+                continue;
+
+            const int            points = v.tablePoints;
+            SpatialRate          rate;
+            SpatialCoeffTable    table;
+            std::vector<uint8_t> tableStorage(SpatialCoeffTable::storageBytes(points ? points : 1));
+            auto*                state = new SpatialAudioState();
+            rate.set(static_cast<float>(o.rate));
+            state->rate = &rate;
+            state->filter = v.filter;
+            state->kernel = v.kernel;
+            setSpatialQuality(state, v.quality);
+            const int            reflLength = reflectionHistoryLength(rate.sampleRate, 10.0f);
+            std::vector<uint8_t> reflStorage(reflLength * DelayBuffer::kSampleBytes);
+            state->reflHistory.bind(reflStorage.data(), reflLength);
+            if (points) {
+                table.init(tableStorage.data(), points, rate);
+                state->coeffTable = &table;
+            }
+
+            std::vector<float> in(frames), outL(frames), outR(frames);
+            uint32_t seed = 1;
+            fillNoise(in.data(), frames, seed, 1.0f);
+
+            const long   blocks       = std::max(1L, static_cast<long>(o.seconds * o.rate / frames));
+            const double blockSeconds = frames / static_cast<double>(o.rate);
+            double       best         = 1e300;
+
+            for (int rep = 0; rep < o.repeats; ++rep) {
+                auto t0 = Clock::now();
+                for (long b = 0; b < blocks; ++b) {
+                    int az, el;
+                    motionAngles(static_cast<Motion>(m), 0, 1, b, blockSeconds, az, el);
+                    const float a = az * (M_PI / 180.0f), e = el * (M_PI / 180.0f);
+                    const float d = 10.0f;
+                    if (v.fused)
+                        applyMonoSpatialAudioMix(in.data(), outL.data(), outR.data(), frames,
+                                                 d * sinf(a), d * sinf(e), d * cosf(a),
+                                                 0.5f, 0.5f, false, state);
+                    else
+                        applyMonoSpatialAudio(in.data(), outL.data(), outR.data(), frames,
+                                              d * sinf(a), d * sinf(e), d * cosf(a), state);
+                }
+                best = std::min(best, elapsedNs(t0, Clock::now()));
+            }
+
+            const double perSample = best / (static_cast<double>(blocks) * frames);
+            report(results, { name, 1, frames, kMotionNames[m], perSample,
+                              best / blocks, 100.0 * perSample * o.rate * 1e-9 });
+            delete state;
+        }
+    }
+}
+
+// ────────────────────────────────────────────────────────────────
+// Coefficient table accuracy – worst magnitude-response deviation
+// from the exact builders over a dense sinAz / elevN sweep
+// ────────────────────────────────────────────────────────────────
+static double magnitudeDb(const BiquadCoeffs& c, double w)
+{
+    // |B(e^jw)| / |A(e^jw)|
+    double cr = cos(w), ci = -sin(w), c2r = cos(2 * w), c2i = -sin(2 * w);
+    double br = c.b0 + c.b1 * cr + c.b2 * c2r, bi = c.b1 * ci + c.b2 * c2i;
+    double ar = 1.0  + c.a1 * cr + c.a2 * c2r, ai = c.a1 * ci + c.a2 * c2i;
+    return 10.0 * log10((br * br + bi * bi) / (ar * ar + ai * ai) + 1e-30);
+}
+
+static void reportTableAccuracy(const BenchOptions& o)
+{
+    if (!matches(o, "table-accuracy"))
+        return;
+
+    printf("\n%-20s %8s %14s %14s\n", "table-accuracy", "bytes", "shelf max dB", "notch max dB");
+    SpatialRate rate;
+    rate.set(static_cast<float>(o.rate));
+    const int points[] = { 9, 17, 33, 65, 129 };
+    for (int n : points) {
+        SpatialCoeffTable    table;
+        std::vector<uint8_t> storage(SpatialCoeffTable::storageBytes(n));
+        table.init(storage.data(), n, rate);
+
+        double shelfErr = 0.0, notchErr = 0.0;
+        for (int k = 0; k <= 2000; ++k) {
+            float        x = -1.0f + k / 1000.0f;
+            BiquadCoeffs exactS, exactN, tabS, tabN;
+            highShelfCoeffs(rate, kShelfFc, kShelfMaxDb * x, exactS);
+            notchCoeffs(rate, kNotchFc + kNotchSpan * x, kNotchQ, exactN);
+            table.shelf(x, tabS);
+            table.notch(x, tabN);
+            // Log-spaced 50 Hz … 20 kHz; notch depth itself is excluded
+            // by capping both responses at -40 dB.
+            for (int b = 0; b < 96; ++b) {
+                double f = 50.0 * pow(400.0, b / 95.0);
+                double w = 2.0 * M_PI * f / o.rate;
+                shelfErr = std::max(shelfErr, fabs(magnitudeDb(exactS, w) - magnitudeDb(tabS, w)));
+                notchErr = std::max(notchErr, fabs(std::max(-40.0, magnitudeDb(exactN, w)) -
+                                                   std::max(-40.0, magnitudeDb(tabN, w))));
+            }
+        }
+        printf("points=%-13d %8u %14.4f %14.4f\n", n, SpatialCoeffTable::storageBytes(n), shelfErr, notchErr);
+    }
+    printf("\n");
+}
+
+// ────────────────────────────────────────────────────────────────
+// Filter modulation artefacts – high-frequency residue of a 500 Hz
+// sine through the full-tier kernel as the source moves, per shelf /
+// notch topology.  The third difference suppresses the sine by ≈71 dB
+// and passes the broadband part of zipper noise and clicks, so the
+// residue rises above the static figure by the artefacts' level.  ITD
+// and reflection motion add the same to every row.
+// ────────────────────────────────────────────────────────────────
+struct FilterVariant {
+    const char*   name;
+    SpatialFilter filter;
+    int           tablePoints;
+};
+
+static double modulationResidueDb(const BenchOptions& o, const FilterVariant& v, Motion m)
+{
+    const int            frames = 16;
+    SpatialRate          rate;
+    SpatialCoeffTable    table;
+    std::vector<uint8_t> tableStorage(SpatialCoeffTable::storageBytes(v.tablePoints ? v.tablePoints : 1));
+    auto*                state = new SpatialAudioState();
+    rate.set(static_cast<float>(o.rate));
+    state->rate   = &rate;
+    state->filter = v.filter;
+    setSpatialKernel(state);
+    if (v.tablePoints) {
+        table.init(tableStorage.data(), v.tablePoints, rate);
+        state->coeffTable = &table;
+    }
+
+    std::vector<float> in(frames), outL(frames), outR(frames);
+    const long   blocks       = o.rate / frames;                   // 1 s
+    const double blockSeconds = frames / static_cast<double>(o.rate);
+    double       signal = 0.0, residue = 0.0;
+    float        y1 = 0.0f, y2 = 0.0f, y3 = 0.0f;
+    for (long b = 0; b < blocks; ++b) {
+        for (int n = 0; n < frames; ++n)
+            in[n] = static_cast<float>(sin(2 * M_PI * 500.0 * (b * frames + n) / o.rate));
+
+        // Sweep: azimuth and elevation across their range and back, 4 Hz
+        float a, e;
+        if (m == kMotionOrbit) {
+            double tri = fabs(fmod(b * blockSeconds * 4.0, 2.0) - 1.0) * 2.0 - 1.0;      // −1…1
+            a = static_cast<float>(tri * M_PI / 2);
+            e = static_cast<float>(-tri * M_PI / 2 * 0.9);
+        } else {
+            int az, el;
+            motionAngles(m, 0, 1, b, blockSeconds, az, el);
+            a = az * (M_PI / 180.0f);
+            e = el * (M_PI / 180.0f);
+        }
+        const float d = 2.0f;
+        applyMonoSpatialAudio(in.data(), outL.data(), outR.data(), frames,
+                              d * cosf(e) * sinf(a), d * sinf(e), d * cosf(e) * cosf(a), state);
+
+        for (int n = 0; n < frames; ++n) {
+            float y = outL[n];
+            float r = y - 3.0f * y1 + 3.0f * y2 - y3;
+            y3 = y2; y2 = y1; y1 = y;
+            if (b * blockSeconds >= 0.1) {
+                signal  += static_cast<double>(y) * y;
+                residue += static_cast<double>(r) * r;
+            }
+        }
+    }
+    delete state;
+    return 10.0 * log10(residue / (signal + 1e-30) + 1e-30);
+}
+
+static void reportFilterModulation(const BenchOptions& o)
+{
+    if (!matches(o, "filter-modulation"))
+        return;
+
+    const FilterVariant variants[] = {
+        { "filter=biquad",         kFilterBiquad, 0 },
+        { "filter=biquad-table65", kFilterBiquad, 65 },
+        { "filter=svf",            kFilterSvf,    0 },
+    };
+    printf("%-22s %11s %11s %11s\n", "filter-modulation", "static dB", "sweep dB", "jumps dB");
+    for (const FilterVariant& v : variants)
+        printf("%-22s %11.1f %11.1f %11.1f\n", v.name, modulationResidueDb(o, v, kMotionStatic),
+               modulationResidueDb(o, v, kMotionOrbit), modulationResidueDb(o, v, kMotionJumps));
+    printf("\n");
+}
+
+// ────────────────────────────────────────────────────────────────
+// Delay storage accuracy – SNR of each history format against float
+// through a swept Lagrange tap, at several input levels
+// ────────────────────────────────────────────────────────────────
+template <class Codec>
+static void delayAccuracyRow(const char* name, const BenchOptions& o)
+{
+    const float levels[] = { 10.0f, 1.0f, 0.1f, 0.01f };      // V peak
+    const int   samples  = o.rate;
+    const int   reflLength = reflectionHistoryLength(static_cast<float>(o.rate), 10.0f);
+    printf("%-20s %8u %10u", name, static_cast<unsigned>(sizeof(DelayHistory<kItdHistory, Codec>)),
+           static_cast<unsigned>(reflLength * sizeof(typename Codec::Stored)));
+
+    for (float level : levels) {
+        auto*    ref = new DelayHistory<kItdHistory, DelayCodecFloat>();
+        auto*    hist = new DelayHistory<kItdHistory, Codec>();
+        DelayTap tapRef, tap;
+        double   signal = 0.0, noise = 0.0;
+        for (int n = 0; n < samples; ++n) {
+            double t = static_cast<double>(n) / o.rate;
+            float  x = static_cast<float>(level * (0.6 * sin(2 * M_PI * 440.0 * t) +
+                                                   0.3 * sin(2 * M_PI * 3150.0 * t) +
+                                                   0.1 * sin(2 * M_PI * 11025.0 * t)));
+            ref->write(x);
+            hist->write(x);
+            float delay = 20.0f + 19.0f * static_cast<float>(sin(2 * M_PI * 0.5 * t));
+            float a = ref->read<kInterpLagrange3>(tapRef, delay);
+            float b = hist->template read<kInterpLagrange3>(tap, delay);
+            signal += static_cast<double>(a) * a;
+            noise  += static_cast<double>(a - b) * (a - b);
+        }
+        delete ref;
+        delete hist;
+        if (noise > 0.0)
+            printf(" %9.1f", 10.0 * log10(signal / noise));
+        else
+            printf(" %9s", "exact");
+    }
+    printf("\n");
+}
+
+static void reportDelayAccuracy(const BenchOptions& o)
+{
+    if (!matches(o, "delay-accuracy"))
+        return;
+
+    printf("%-20s %8s %10s %9s %9s %9s %9s\n", "delay-accuracy", "itd B", "refl B", "10 V dB",
+           "1 V dB", "0.1 V dB", "10 mV dB");
+    delayAccuracyRow<DelayCodecFloat>("format=float", o);
+    delayAccuracyRow<DelayCodecInt16>("format=int16", o);
+    delayAccuracyRow<DelayCodecHalf>("format=float16", o);
+    printf("(this build: %s)\n\n", TINEAR_DELAY_FORMAT == 1 ? "int16" : TINEAR_DELAY_FORMAT == 2 ? "float16" : "float");
+}
+
+// ────────────────────────────────────────────────────────────────
+// Plugin benchmark – full step() through the factory
+// ────────────────────────────────────────────────────────────────
+struct EmitterParams {
+    int azimuth, elevation;
+};
+
+static int findParam(const _NT_algorithm* alg, const char* pageName, const char* paramName)
+{
+    const _NT_parameterPages* pages = alg->parameterPages;
+    for (uint32_t i = 0; i < pages->numPages; ++i) {
+        const _NT_parameterPage& page = pages->pages[i];
+        if (strcmp(page.name, pageName) != 0)
+            continue;
+        for (int j = 0; j < page.numParams; ++j) {
+            int p = page.params[j];
+            if (strstr(alg->parameters[p].name, paramName))
+                return p;
+        }
+    }
+    return -1;
+}
+
+// Any page, exact parameter name
+static int findParam(const _NT_algorithm* alg, int numParameters, const char* paramName)
+{
+    for (int p = 0; p < numParameters; ++p)
+        if (strcmp(alg->parameters[p].name, paramName) == 0)
+            return p;
+    return -1;
+}
+
+static void applyParam(NtHostAlgorithm& host, const char* name, int value)
+{
+    int p = findParam(host.algorithm, host.numParameters(), name);
+    if (p < 0)
+        fprintf(stderr, "unknown parameter \"%s\"\n", name);
+    else
+        host.setParameter(p, static_cast<int16_t>(value));
+}
+
+// Factory defaults for every specification, with --spec overrides
+static std::vector<int32_t> specifications(const BenchOptions& o, const _NT_factory* factory)
+{
+    std::vector<int32_t> specs(factory->numSpecifications);
+    for (uint32_t i = 0; i < factory->numSpecifications; ++i) {
+        specs[i] = factory->specifications[i].def;
+        for (const auto& ov : o.specOverrides)
+            if (ov.first == factory->specifications[i].name)
+                specs[i] = ov.second;
+    }
+    return specs;
+}
+
+// ────────────────────────────────────────────────────────────────
+// Memory footprint – requirements by region, and per emitter – and
+// construct() time, after the static tables every instance shares
+// ────────────────────────────────────────────────────────────────
+static void reportFootprint(const BenchOptions& o)
+{
+    const _NT_factory* factory = NT_hostFactory();
+    std::vector<int32_t> specs = specifications(o, factory);
+    printf("static dram %u bytes, shared by every instance\n", NT_hostStaticDram(factory));
+    int maxDistance = -1;
+    for (uint32_t i = 0; i < factory->numSpecifications; ++i)
+        if (strcmp(factory->specifications[i].name, "Max distance") == 0)
+            maxDistance = static_cast<int>(i);
+
+    printf("memory footprint at %d Hz (bytes; per emitter = 8 emitters − 1, / 7)\n", o.rate);
+    printf("%-16s %10s %10s %10s %12s %12s\n", "max distance", "sram", "dtc", "dram",
+           "dtc/emitter", "dram/emitter");
+    for (int metres : { 10, 30, 100 }) {
+        if (maxDistance >= 0)
+            specs[maxDistance] = metres;
+        _NT_algorithmRequirements one{}, eight{};
+        specs[0] = 1;
+        factory->calculateRequirements(one, specs.data());
+        specs[0] = 8;
+        factory->calculateRequirements(eight, specs.data());
+        printf("%-16d %10u %10u %10u %12u %12u\n", metres, eight.sram, eight.dtc, eight.dram,
+               (eight.dtc - one.dtc) / 7, (eight.dram - one.dram) / 7);
+    }
+
+    // Allocation, construct() and the default parameterChanged pass
+    specs = specifications(o, factory);
+    for (int emitters : { 1, 8 }) {
+        specs[0] = emitters;
+        double best = 1e300;
+        for (int rep = 0; rep < 5; ++rep) {
+            NtHostAlgorithm host;
+            auto t0 = Clock::now();
+            host.create(factory, specs.data());
+            best = std::min(best, elapsedNs(t0, Clock::now()));
+        }
+        printf("construct e%-5d %10.1f us\n", emitters, best * 1e-3);
+    }
+    printf("\n");
+}
+
+static void benchStep(const BenchOptions& o, std::vector<BenchResult>& results)
+{
+    const _NT_factory* factory = NT_hostFactory();
+    std::vector<int32_t> specs = specifications(o, factory);
+    const std::vector<int32_t> defaults = specs;
+    int cvInputs = -1, speakers = -1;
+    for (uint32_t i = 0; i < factory->numSpecifications; ++i) {
+        if (strcmp(factory->specifications[i].name, "CV inputs") == 0)
+            cvInputs = static_cast<int>(i);
+        if (strcmp(factory->specifications[i].name, "Speakers") == 0)
+            speakers = static_cast<int>(i);
+    }
+
+    for (const StepVariant& variant : kStepVariants)
+    for (int numEmitters : kEmitterCounts) {
+        if (o.quick && numEmitters != 1 && numEmitters != 4 && numEmitters != 8 && numEmitters != 32)
+            continue;
+
+        for (int by4 : kBlockSizesBy4) {
+            const int frames = by4 * 4;
+            if (o.quick && frames != 16 && frames != 128 && frames != kMaxBenchFrames)
+                continue;
+
+            for (int m = 0; m < kNumMotions; ++m) {
+                char name[64];
+                snprintf(name, sizeof(name), "%s/e%d/f%d/%s", variant.prefix, numEmitters, frames,
+                         kMotionNames[m]);
+                if (!matches(o, name))
+                    continue;
+
+                NtHostAlgorithm host;
+                specs[0] = numEmitters;
+                if (cvInputs >= 0)
+                    specs[cvInputs] = variant.cv ? factory->specifications[cvInputs].max : defaults[cvInputs];
+                if (speakers >= 0)
+                    specs[speakers] = variant.speakers ? variant.speakers : defaults[speakers];
+                if (!host.create(factory, specs.data())) {
+                    fprintf(stderr, "construct failed for %s\n", name);
+                    continue;
+                }
+                for (const ParamSetting& ps : variant.params)
+                    if (ps.name)
+                        applyParam(host, ps.name, ps.value);
+                for (const auto& ov : o.paramOverrides)
+                    applyParam(host, ov.first.c_str(), ov.second);
+
+                std::vector<EmitterParams> ep(numEmitters);
+                for (int e = 0; e < numEmitters; ++e) {
+                    char page[24];
+                    snprintf(page, sizeof(page), "Emitter %d", e + 1);
+                    ep[e].azimuth   = findParam(host.algorithm, page, "Azimuth");
+                    ep[e].elevation = findParam(host.algorithm, page, "Elevation");
+                    if (variant.idleOdd && (e & 1))
+                        host.setParameter(findParam(host.algorithm, page, "Input"), kSilentBus);
+                    const int azimuthCv = findParam(host.algorithm, page, "Azimuth CV");
+                    if (variant.cv && azimuthCv >= 0) {
+                        host.setParameter(azimuthCv, kCvBus);
+                        host.setParameter(findParam(host.algorithm, page, "Distance CV"), kCvBus);
+                    }
+                }
+
+                std::vector<float> bus(kNtHostNumBusses * frames);
+                std::vector<float> inputs(kNtHostNumBusses * frames);
+                uint32_t seed = 12345;
+                fillNoise(inputs.data(), 12 * frames, seed, 5.0f);   // busses 1–12
+
+                const long   blocks       = std::max(1L, static_cast<long>(o.seconds * o.rate / frames));
+                const double blockSeconds = frames / static_cast<double>(o.rate);
+                double       best         = 1e300;
+
+                for (int rep = 0; rep < o.repeats; ++rep) {
+                    double total = 0.0;
+                    for (long b = 0; b < blocks; ++b) {
+                        for (int e = 0; e < numEmitters; ++e) {
+                            int az, el;
+                            motionAngles(static_cast<Motion>(m), e, numEmitters, b, blockSeconds, az, el);
+                            host.setParameter(ep[e].azimuth, static_cast<int16_t>(az));
+                            host.setParameter(ep[e].elevation, static_cast<int16_t>(el));
+                        }
+                        memcpy(bus.data(), inputs.data(), bus.size() * sizeof(float));
+                        if (variant.head) {
+                            // Yaw sweeps once a second, pitch nods at 1/3 of that
+                            const double t = b * blockSeconds;
+                            const int yaw = static_cast<int>(8192 + 8191 * sin(2.0 * M_PI * t));
+                            const int pitch = static_cast<int>(8192 + 4096 * sin(2.0 * M_PI * t / 3.0));
+                            host.midiMessage(0xb0, 16, static_cast<uint8_t>(yaw >> 7));
+                            host.midiMessage(0xb0, 48, static_cast<uint8_t>(yaw & 0x7f));
+                            host.midiMessage(0xb0, 17, static_cast<uint8_t>(pitch >> 7));
+                            host.midiMessage(0xb0, 49, static_cast<uint8_t>(pitch & 0x7f));
+                        }
+
+                        auto t0 = Clock::now();
+                        host.step(bus.data(), by4);
+                        total += elapsedNs(t0, Clock::now());
+                    }
+                    best = std::min(best, total);
+                }
+
+                const double perSampleEmitter = best / (static_cast<double>(blocks) * frames * numEmitters);
+                report(results, { name, numEmitters, frames, kMotionNames[m], perSampleEmitter,
+                                  best / blocks,
+                                  100.0 * perSampleEmitter * numEmitters * o.rate * 1e-9 });
+                if (o.draw) {
+                    NT_hostBeginTextCapture();
+                    host.draw();
+                    NT_hostEndTextCapture(stdout);
+                }
+            }
+        }
+    }
+}
+
+// ────────────────────────────────────────────────────────────────
+// JSON summary & regression comparison
+// ────────────────────────────────────────────────────────────────
+static bool writeJson(const BenchOptions& o, const std::vector<BenchResult>& results)
+{
+    FILE* f = fopen(o.jsonPath.c_str(), "w");
+    if (!f)
+        return false;
+    fprintf(f, "{\n  \"schema\": \"tinear-bench-1\",\n");
+    fprintf(f, "  \"sample_rate\": %d,\n", o.rate);
+    fprintf(f, "  \"compiler\": \"%s\",\n", __VERSION__);
+    fprintf(f, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        // One result per line so the file diffs and parses trivially.
+        fprintf(f, "    {\"name\": \"%s\", \"emitters\": %d, \"frames\": %d, \"motion\": \"%s\", "
+                   "\"ns_per_sample_emitter\": %.4f, \"ns_per_block\": %.1f, \"cpu_percent\": %.4f}%s\n",
+                r.name.c_str(), r.emitters, r.frames, r.motion, r.nsPerSampleEmitter,
+                r.nsPerBlock, r.cpuPercent, (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return true;
+}
+
+struct BaselineEntry {
+    std::string name;
+    double      nsPerSampleEmitter;
+};
+
+static std::vector<BaselineEntry> readBaseline(const std::string& path)
+{
+    std::vector<BaselineEntry> out;
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f)
+        return out;
+    char line[1024];
+    while (fgets(line, sizeof(line), f)) {
+        const char* n = strstr(line, "\"name\": \"");
+        const char* v = strstr(line, "\"ns_per_sample_emitter\": ");
+        if (!n || !v)
+            continue;
+        n += 9;
+        const char* end = strchr(n, '"');
+        if (!end)
+            continue;
+        out.push_back({ std::string(n, end), atof(v + 25) });
+    }
+    fclose(f);
+    return out;
+}
+
+static int compareBaseline(const BenchOptions& o, const std::vector<BenchResult>& results)
+{
+    std::vector<BaselineEntry> base = readBaseline(o.comparePath);
+    if (base.empty()) {
+        fprintf(stderr, "no baseline results in %s\n", o.comparePath.c_str());
+        return 2;
+    }
+
+    int regressions = 0;
+    printf("\n%-36s %10s %10s %8s\n", "comparison", "baseline", "current", "delta");
+    for (const BenchResult& r : results) {
+        auto it = std::find_if(base.begin(), base.end(),
+                               [&](const BaselineEntry& b) { return b.name == r.name; });
+        if (it == base.end() || it->nsPerSampleEmitter <= 0.0)
+            continue;
+        double delta = 100.0 * (r.nsPerSampleEmitter - it->nsPerSampleEmitter) / it->nsPerSampleEmitter;
+        bool   bad   = delta > o.threshold;
+        regressions += bad;
+        printf("%-36s %10.2f %10.2f %+7.1f%%%s\n", r.name.c_str(), it->nsPerSampleEmitter,
+               r.nsPerSampleEmitter, delta, bad ? "  REGRESSION" : "");
+    }
+    printf("%d regression(s) above %.1f%%\n", regressions, o.threshold);
+    return regressions ? 1 : 0;
+}
+
+static void usage(const char* argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--quick] [--seconds S] [--repeats N] [--filter TEXT] [--rate HZ]\n"
+            "          [--spec NAME=VALUE] [--param NAME=VALUE] [--json OUT]\n"
+            "          [--compare BASELINE]\n"
+            "          [--threshold PCT] [--draw]\n",
+            argv0);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    BenchOptions o;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) { usage(argv[0]); exit(2); }
+            return argv[++i];
+        };
+        if (a == "--quick")          { o.quick = true; o.seconds = 0.25; o.repeats = 2; }
+        else if (a == "--seconds")   o.seconds = atof(next());
+        else if (a == "--repeats")   o.repeats = std::max(1, atoi(next()));
+        else if (a == "--filter")    o.filter = next();
+        else if (a == "--json")      o.jsonPath = next();
+        else if (a == "--compare")   o.comparePath = next();
+        else if (a == "--threshold") o.threshold = atof(next());
+        else if (a == "--rate")      o.rate = std::max(8000, atoi(next()));
+        else if (a == "--draw")      o.draw = true;
+        else if (a == "--spec" || a == "--param") {
+            std::string kv = next();
+            size_t      eq = kv.find('=');
+            if (eq == std::string::npos) { usage(argv[0]); return 2; }
+            auto& list = (a == "--spec") ? o.specOverrides : o.paramOverrides;
+            list.push_back({ kv.substr(0, eq), atoi(kv.c_str() + eq + 1) });
+        }
+        else { usage(argv[0]); return 2; }
+    }
+
+#if defined(__SSE__)
+    // The Cortex-M7 runs with flush-to-zero; match it so decaying tails
+    // don't measure denormal stalls that never happen on hardware.
+    _mm_setcsr(_mm_getcsr() | 0x8040);
+#endif
+
+    NT_hostSetSampleRate(static_cast<uint32_t>(o.rate));
+    printf("sample rate %d Hz\n", o.rate);
+
+    std::vector<BenchResult> results;
+    reportTableAccuracy(o);
+    reportDelayAccuracy(o);
+    reportFilterModulation(o);
+    reportFootprint(o);
+    benchKernel(o, results);
+    benchStep(o, results);
+
+    if (!o.jsonPath.empty() && !writeJson(o, results)) {
+        fprintf(stderr, "cannot write %s\n", o.jsonPath.c_str());
+        return 2;
+    }
+    if (!o.comparePath.empty())
+        return compareBaseline(o, results);
+    return 0;
+}
@@ -0,0 +1,140 @@
+// Fast math for the control and coefficient paths
+// -------------------------------------------------------------------
+// • Header-only polynomial approximations of the libm calls the engine
+//   makes per block and per coefficient update, sized for the
+//   Cortex-M7 FPU: no tables, no divides except fastAsin's one sqrt.
+// • Maximum errors below are measured over every float in the stated
+//   domain by bench/fast_math_accuracy.cpp (make fast-math-accuracy),
+//   which fails if any bound is exceeded.  All are well under what the
+//   slew-limited controls and smoothed coefficients could reveal.
+//
+//   function        domain              max error
+//   fastSin/Cos     |x| ≤ 4π            2.5e-7 absolute
+//   fastAsin        [−1, 1]             3.0e-7 absolute
+//   fastSqrt        x ≥ 0               exact (correctly rounded)
+//   fastExp2        [−126, 127]         3.0e-7 relative
+//   fastPow10       [−30, 30]           3.0e-7 relative
+//   fastDbToGain    [−120, 120] dB      3.0e-7 relative
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>      // memcpy
+
+// x − 2πk in [−π, π]; 2π is split so k·2π stays exact for small k
+static inline float fastReduceAngle(float x)
+{
+    float k = floorf(x * 0.15915494f + 0.5f);
+    return (x - k * 6.28125f) - k * 1.9353072e-3f;
+}
+
+// sin on [−π/2, π/2]: least-squares odd polynomial of degree 9
+static inline float fastSinKernel(float x)
+{
+    float z = x * x;
+    float p = 2.5904300e-6f;
+    p = p * z - 1.9800865e-4f;
+    p = p * z + 8.3328992e-3f;
+    p = p * z - 1.6666648e-1f;
+    p = p * z + 9.9999998e-1f;
+    return p * x;
+}
+
+static inline float fastSin(float x)
+{
+    x = fastReduceAngle(x);
+    if (x > 1.5707964f)
+        x = 3.1415927f - x;
+    else if (x < -1.5707964f)
+        x = -3.1415927f - x;
+    return fastSinKernel(x);
+}
+
+// cos(x) = sin(π/2 − |x|), exact subtraction over most of the period
+static inline float fastCos(float x)
+{
+    return fastSinKernel(1.5707964f - fabsf(fastReduceAngle(x)));
+}
+
+// Hardware square root on the M7 (VSQRT, 14 cycles) without the libm
+// errno path; the host builtin is correctly rounded too
+static inline float fastSqrt(float x)
+{
+#if defined(__ARM_FP)
+    float r;
+    __asm__("vsqrt.f32 %0, %1" : "=t"(r) : "t"(x));
+    return r;
+#else
+    return __builtin_sqrtf(x);
+#endif
+}
+
+// asin: odd polynomial on |x| ≤ 0.5, and asin(x) = π/2 − 2·asin(√((1−x)/2))
+// above (Cephes coefficients)
+static inline float fastAsin(float x)
+{
+    float a = fabsf(x);
+    float z, s;
+    bool  upper = a > 0.5f;
+    if (upper) {
+        z = 0.5f * (1.0f - a);
+        s = fastSqrt(z);
+    } else {
+        z = a * a;
+        s = a;
+    }
+
+    float p = 4.2163199e-2f;
+    p = p * z + 2.4181311e-2f;
+    p = p * z + 4.5470026e-2f;
+    p = p * z + 7.4953003e-2f;
+    p = p * z + 1.6666752e-1f;
+    float r = s + s * z * p;
+    if (upper)
+        r = 1.5707964f - 2.0f * r;
+    return (x < 0.0f) ? -r : r;
+}
+
+// 2^k · 2^f for integer k and |f| ≲ ½: k into the exponent field, 2^f
+// from a degree-5 polynomial fitted for relative error
+static inline float fastExp2Parts(float k, float f)
+{
+    k = (k < -126.0f) ? -126.0f : (k > 127.0f) ? 127.0f : k;
+
+    float p = 1.3266970e-3f;
+    p = p * f + 9.6754597e-3f;
+    p = p * f + 5.5507426e-2f;
+    p = p * f + 2.4022122e-1f;
+    p = p * f + 6.9314695e-1f;
+    p = p * f + 1.0f;
+
+    uint32_t bits = static_cast<uint32_t>(static_cast<int32_t>(k) + 127) << 23;
+    float scale;
+    memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+static inline float fastExp2(float x)
+{
+    x = (x < -126.0f) ? -126.0f : (x > 127.0f) ? 127.0f : x;
+    float k = floorf(x + 0.5f);
+    return fastExp2Parts(k, x - k);
+}
+
+// 10^x = 2^k · 2^((x − k·log10 2)·log2 10), with log10 2 split so the
+// reduction is exact and scaling x by log2 10 doesn't cost precision
+static inline float fastPow10(float x)
+{
+    float k = floorf(x * 3.3219281f + 0.5f);
+    float r = (x - k * 0.301025390625f) - k * 4.6050390e-6f;
+    return fastExp2Parts(k, r * 3.3219281f);
+}
+
+// 10^(dB / 20), reduced the same way with 20·log10 2 dB per octave
+static inline float fastDbToGain(float db)
+{
+    float k = floorf(db * 0.16609640f + 0.5f);
+    float r = (db - k * 6.0205078125f) - k * 9.2100780e-5f;
+    return fastExp2Parts(k, r * 0.16609640f);
+}
@@ -0,0 +1,215 @@
+// Host stand-in for <distingnt/api.h>
+// -------------------------------------------------------------------
+// • Minimal subset of the distingNT plugin API needed to compile and
+//   drive Tin Ear natively (benchmarks, offline tools).
+// • Layouts mirror libs/distingNT_API/include/distingnt/api.h closely
+//   enough for the plugin sources to build unmodified; anything the
+//   plugin does not touch is left out.
+// • The hardware build never sees this file – the Makefile only adds
+//   host/ to the include path for host targets.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define NT_MULTICHAR(a, b, c, d) \
+    (((uint32_t)(a) << 0) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+#ifndef ARRAY_SIZE
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
+#endif
+
+enum {
+    kNT_apiVersion1 = 1,
+    kNT_apiVersion2,
+    kNT_apiVersion3,
+    kNT_apiVersion4,
+    kNT_apiVersion5,
+    kNT_apiVersion6,
+    kNT_apiVersionCurrent = kNT_apiVersion6,
+};
+
+// ───────── Globals supplied by the host ─────────────────────────
+struct _NT_globals {
+    uint32_t sampleRate;
+    uint32_t maxFramesPerStep;
+    float*   workBuffer;
+    uint32_t workBufferSizeBytes;
+};
+
+// host/nt_host.cpp defines this mutable so host tools can change the rate.
+#ifndef NT_HOST_DEFINES_GLOBALS
+extern const _NT_globals NT_globals;
+#endif
+
+// ───────── Parameters ───────────────────────────────────────────
+enum _NT_unit {
+    kNT_unitNone,
+    kNT_unitEnum,
+    kNT_unitDb,
+    kNT_unitDb_minInf,
+    kNT_unitPercent,
+    kNT_unitHz,
+    kNT_unitSemitones,
+    kNT_unitCents,
+    kNT_unitMs,
+    kNT_unitSeconds,
+    kNT_unitFrames,
+    kNT_unitMIDINote,
+    kNT_unitMillivolts,
+    kNT_unitVolts,
+    kNT_unitBPM,
+    kNT_unitAudioInput = 100,
+    kNT_unitCvInput,
+    kNT_unitAudioOutput,
+    kNT_unitCvOutput,
+    kNT_unitOutputMode,
+};
+
+enum _NT_scaling {
+    kNT_scalingNone,
+    kNT_scaling10,
+    kNT_scaling100,
+    kNT_scaling1000,
+};
+
+struct _NT_parameter {
+    const char*        name;
+    int16_t            min;
+    int16_t            max;
+    int16_t            def;
+    uint8_t            unit;
+    uint8_t            scaling;
+    char const* const* enumStrings;
+};
+
+struct _NT_parameterPage {
+    const char*    name;
+    uint8_t        numParams;
+    uint8_t        group;
+    uint8_t        unused[2];
+    const uint8_t* params;
+};
+
+struct _NT_parameterPages {
+    uint32_t                 numPages;
+    const _NT_parameterPage* pages;
+};
+
+// ───────── Specifications ───────────────────────────────────────
+enum _NT_specificationType {
+    kNT_typeGeneric,
+    kNT_typeSeconds,
+    kNT_typeMs,
+};
+
+struct _NT_specification {
+    const char* name;
+    int32_t     min;
+    int32_t     max;
+    int32_t     def;
+    int32_t     type;
+};
+
+// ───────── Memory ───────────────────────────────────────────────
+struct _NT_staticRequirements {
+    uint32_t dram;
+};
+
+struct _NT_staticMemoryPtrs {
+    uint8_t* dram;
+};
+
+struct _NT_algorithmRequirements {
+    uint32_t numParameters;
+    uint32_t sram;
+    uint32_t dram;
+    uint32_t dtc;
+    uint32_t itc;
+};
+
+struct _NT_algorithmMemoryPtrs {
+    uint8_t* sram;
+    uint8_t* dram;
+    uint8_t* dtc;
+    uint8_t* itc;
+};
+
+// ───────── Algorithm & factory ──────────────────────────────────
+struct _NT_algorithm {
+    _NT_algorithm() : parameters(NULL), parameterPages(NULL), vIncludingCommon(NULL), v(NULL) {}
+
+    const _NT_parameter*      parameters;
+    const _NT_parameterPages* parameterPages;
+    const int16_t*            vIncludingCommon;
+    const int16_t*            v;
+};
+
+enum _NT_tag {
+    kNT_tagInstrument = (1 << 0),
+    kNT_tagEffect     = (1 << 1),
+    kNT_tagFilter     = (1 << 2),
+    kNT_tagEQ         = (1 << 3),
+    kNT_tagDelay      = (1 << 4),
+    kNT_tagReverb     = (1 << 5),
+    kNT_tagRouting    = (1 << 6),
+    kNT_tagUtility    = (1 << 7),
+};
+
+struct _NT_uiData;
+struct _NT_float3;
+struct _NT_jsonStream;
+struct _NT_jsonParse;
+
+struct _NT_factory {
+    uint32_t                 guid;
+    const char*              name;
+    const char*              description;
+    uint32_t                 numSpecifications;
+    const _NT_specification* specifications;
+    void           (*calculateStaticRequirements)(_NT_staticRequirements& req);
+    void           (*initialise)(_NT_staticMemoryPtrs& ptrs, const _NT_staticRequirements& req);
+    void           (*calculateRequirements)(_NT_algorithmRequirements& req, const int32_t* specifications);
+    _NT_algorithm* (*construct)(const _NT_algorithmMemoryPtrs& ptrs, const _NT_algorithmRequirements& req, const int32_t* specifications);
+    void           (*parameterChanged)(_NT_algorithm* self, int p);
+    void           (*step)(_NT_algorithm* self, float* busFrames, int numFramesBy4);
+    bool           (*draw)(_NT_algorithm* self);
+    void           (*midiRealtime)(_NT_algorithm* self, uint8_t byte);
+    void           (*midiMessage)(_NT_algorithm* self, uint8_t byte0, uint8_t byte1, uint8_t byte2);
+    uint32_t       tags;
+    uint32_t       (*hasCustomUi)(_NT_algorithm* self);
+    void           (*customUi)(_NT_algorithm* self, const _NT_uiData& data);
+    void           (*setupUi)(_NT_algorithm* self, _NT_float3& pots);
+    void           (*serialise)(_NT_algorithm* self, _NT_jsonStream& stream);
+    bool           (*deserialise)(_NT_algorithm* self, _NT_jsonParse& parse);
+    void           (*midiSysEx)(uint8_t byte, int32_t end);
+};
+
+// ───────── Drawing (256 × 64 display) ───────────────────────────
+enum _NT_textSize {
+    kNT_textTiny,
+    kNT_textNormal,
+    kNT_textLarge,
+};
+
+enum _NT_textAlignment {
+    kNT_textLeft,
+    kNT_textCentre,
+    kNT_textRight,
+};
+
+extern "C" {
+void NT_drawText(int x, int y, const char* str, int colour = 15,
+                 _NT_textAlignment align = kNT_textLeft, _NT_textSize size = kNT_textNormal);
+int  NT_intToString(char* buffer, int32_t value);
+}
+
+// ───────── Plugin entry point ───────────────────────────────────
+enum _NT_selector {
+    kNT_selector_version,
+    kNT_selector_numFactories,
+    kNT_selector_factoryInfo,
+};
+
+extern "C" uintptr_t pluginEntry(_NT_selector selector, uint32_t data);
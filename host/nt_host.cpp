@@ -0,0 +1,201 @@
+// Host-side distingNT emulation helpers – see nt_host.h
+
+#define NT_HOST_DEFINES_GLOBALS
+#include "nt_host.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+// Mutable on the host so tools can sweep the sample rate; the plugin
+// only ever sees the const declaration from api.h.
+extern _NT_globals NT_globals;
+_NT_globals NT_globals = { 48000, 512, nullptr, 0 };
+
+void NT_hostSetSampleRate(uint32_t sampleRate)
+{
+    NT_globals.sampleRate = sampleRate;
+}
+
+void NT_hostSetMaxFramesPerStep(uint32_t maxFrames)
+{
+    NT_globals.maxFramesPerStep = maxFrames;
+}
+
+// Drawing goes nowhere on the host unless text capture is on; the
+// formatting helpers are real so draw() code paths run unchanged.
+struct CapturedText {
+    int         x, y;
+    std::string text;
+};
+
+static bool                      captureText = false;
+static std::vector<CapturedText> capturedText;
+
+void NT_hostBeginTextCapture()
+{
+    capturedText.clear();
+    captureText = true;
+}
+
+void NT_hostEndTextCapture(FILE* out)
+{
+    captureText = false;
+    std::stable_sort(capturedText.begin(), capturedText.end(),
+                     [](const CapturedText& a, const CapturedText& b) {
+                         return (a.y != b.y) ? a.y < b.y : a.x < b.x;
+                     });
+    for (size_t i = 0; i < capturedText.size(); ++i) {
+        bool rowStart = (i == 0) || capturedText[i].y != capturedText[i - 1].y;
+        bool rowEnd   = (i + 1 == capturedText.size()) || capturedText[i + 1].y != capturedText[i].y;
+        fprintf(out, "%s%s%s", rowStart ? "  | " : "  ", capturedText[i].text.c_str(), rowEnd ? "\n" : "");
+    }
+}
+
+extern "C" void NT_drawText(int x, int y, const char* str, int, _NT_textAlignment align, _NT_textSize)
+{
+    if (!captureText)
+        return;
+    // Right/centre aligned text is placed by its approximate start
+    // (tiny font ≈ 4 px per character) so rows read left to right
+    int width = 4 * static_cast<int>(strlen(str));
+    if (align == kNT_textRight)
+        x -= width;
+    else if (align == kNT_textCentre)
+        x -= width / 2;
+    capturedText.push_back({ x, y, str });
+}
+
+extern "C" int NT_intToString(char* buffer, int32_t value)
+{
+    char     digits[12];
+    int      n = 0;
+    uint32_t u = (value < 0) ? 0u - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+    do {
+        digits[n++] = static_cast<char>('0' + u % 10);
+        u /= 10;
+    } while (u);
+
+    int len = 0;
+    if (value < 0)
+        buffer[len++] = '-';
+    while (n)
+        buffer[len++] = digits[--n];
+    buffer[len] = '\0';
+    return len;
+}
+
+const _NT_factory* NT_hostFactory()
+{
+    return reinterpret_cast<const _NT_factory*>(pluginEntry(kNT_selector_factoryInfo, 0));
+}
+
+// ────────────────────────────────────────────────────────────────
+// NtHostAlgorithm
+// ────────────────────────────────────────────────────────────────
+static uint8_t* allocBlock(uint32_t bytes)
+{
+    if (bytes == 0)
+        return nullptr;
+    // Cache-line aligned like the module's memory pools.
+    size_t rounded = (bytes + 63u) & ~size_t(63u);
+    void*  p       = aligned_alloc(64, rounded);
+    memset(p, 0, rounded);
+    return static_cast<uint8_t*>(p);
+}
+
+// Static memory is allocated and initialised once per process, on the
+// first create() (at the sample rate then current), like a plugin load
+// on the module, and kept for the process lifetime
+static std::once_flag       staticOnce;
+static _NT_staticRequirements staticRequirements{};
+
+static void initialiseStatic(const _NT_factory* factory)
+{
+    std::call_once(staticOnce, [factory] {
+        if (!factory->calculateStaticRequirements || !factory->initialise)
+            return;
+        factory->calculateStaticRequirements(staticRequirements);
+        _NT_staticMemoryPtrs ptrs{};
+        ptrs.dram = allocBlock(staticRequirements.dram);
+        factory->initialise(ptrs, staticRequirements);
+    });
+}
+
+uint32_t NT_hostStaticDram(const _NT_factory* factory)
+{
+    initialiseStatic(factory);
+    return staticRequirements.dram;
+}
+
+NtHostAlgorithm::~NtHostAlgorithm()
+{
+    release();
+}
+
+void NtHostAlgorithm::release()
+{
+    for (uint8_t*& b : blocks) {
+        free(b);
+        b = nullptr;
+    }
+    algorithm = nullptr;
+}
+
+bool NtHostAlgorithm::create(const _NT_factory* f, const int32_t* specifications)
+{
+    release();
+    factory = f;
+
+    initialiseStatic(factory);
+    factory->calculateRequirements(requirements, specifications);
+
+    _NT_algorithmMemoryPtrs ptrs{};
+    ptrs.sram = blocks[0] = allocBlock(requirements.sram);
+    ptrs.dram = blocks[1] = allocBlock(requirements.dram);
+    ptrs.dtc  = blocks[2] = allocBlock(requirements.dtc);
+    ptrs.itc  = blocks[3] = allocBlock(requirements.itc);
+
+    algorithm = factory->construct(ptrs, requirements, specifications);
+    if (!algorithm)
+        return false;
+
+    values.assign(requirements.numParameters, 0);
+    algorithm->v                = values.data();
+    algorithm->vIncludingCommon = values.data();
+
+    for (uint32_t p = 0; p < requirements.numParameters; ++p) {
+        values[p] = algorithm->parameters[p].def;
+        factory->parameterChanged(algorithm, static_cast<int>(p));
+    }
+    return true;
+}
+
+void NtHostAlgorithm::setParameter(int p, int16_t value)
+{
+    const _NT_parameter& def = algorithm->parameters[p];
+    if (value < def.min) value = def.min;
+    if (value > def.max) value = def.max;
+    if (values[p] == value)
+        return;
+    values[p] = value;
+    factory->parameterChanged(algorithm, p);
+}
+
+void NtHostAlgorithm::step(float* busFrames, int numFramesBy4)
+{
+    factory->step(algorithm, busFrames, numFramesBy4);
+}
+
+void NtHostAlgorithm::midiMessage(uint8_t byte0, uint8_t byte1, uint8_t byte2)
+{
+    if (factory->midiMessage)
+        factory->midiMessage(algorithm, byte0, byte1, byte2);
+}
+
+bool NtHostAlgorithm::draw()
+{
+    return factory->draw ? factory->draw(algorithm) : false;
+}
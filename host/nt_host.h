@@ -0,0 +1,65 @@
+// Host-side distingNT emulation helpers
+// -------------------------------------------------------------------
+// • Drives a plugin factory the way the module firmware does:
+//   calculateStaticRequirements → initialise once per process, then per
+//   instance calculateRequirements → allocate → construct →
+//   parameterChanged for every default → step() on a flat bus buffer.
+// • Used by the benchmark suite and the offline tools; never linked
+//   into the hardware build.
+
+#pragma once
+
+#include <distingnt/api.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Bus layout on the distingNT: 28 busses, each numFrames long.
+constexpr int kNtHostNumBusses = 28;
+
+void NT_hostSetSampleRate(uint32_t sampleRate);
+void NT_hostSetMaxFramesPerStep(uint32_t maxFrames);
+
+// Text drawn by draw() is normally discarded.  Between begin and end
+// it is collected instead, and end prints it one screen row per line.
+void NT_hostBeginTextCapture();
+void NT_hostEndTextCapture(FILE* out);
+
+// Factory exported by the plugin under test (pluginEntry, index 0).
+const _NT_factory* NT_hostFactory();
+
+// Static DRAM of the factory, initialising it if no instance has yet.
+uint32_t NT_hostStaticDram(const _NT_factory* factory);
+
+class NtHostAlgorithm {
+public:
+    NtHostAlgorithm() = default;
+    ~NtHostAlgorithm();
+
+    NtHostAlgorithm(const NtHostAlgorithm&) = delete;
+    NtHostAlgorithm& operator=(const NtHostAlgorithm&) = delete;
+
+    // Allocates and constructs an instance; all parameters are set to
+    // their defaults and reported through parameterChanged.
+    bool create(const _NT_factory* factory, const int32_t* specifications);
+
+    // Writes a parameter value and notifies the algorithm if it changed.
+    void setParameter(int p, int16_t value);
+    int16_t parameter(int p) const { return values[p]; }
+    int numParameters() const { return static_cast<int>(values.size()); }
+
+    void step(float* busFrames, int numFramesBy4);
+    void midiMessage(uint8_t byte0, uint8_t byte1, uint8_t byte2);
+    bool draw();
+
+    _NT_algorithm*            algorithm = nullptr;
+    _NT_algorithmRequirements requirements{};
+
+private:
+    void release();
+
+    const _NT_factory*   factory = nullptr;
+    std::vector<int16_t> values;
+    uint8_t*             blocks[4] = {};
+};
@@ -0,0 +1,192 @@
+// HRIR binaural rendering engine – see hrir_renderer.h
+// -------------------------------------------------------------------
+// • Per-sample work is a FIFO read/write plus the delay taps; the
+//   convolution runs once per kHrirPartition samples.
+
+#include "hrir_renderer.h"
+
+bool HrirRenderer::init(const void* blob, uint32_t bytes)
+{
+    work.fft.init(kHrirFftSize);
+    return dataset.bind(blob, bytes) && dataset.irLength() <= kHrirLength;
+}
+
+// ────────────────────────────────────────────────────────────────
+// Partitioned convolution
+// ────────────────────────────────────────────────────────────────
+// Transforms the left/right HRIRs of a grid point into filter spectra
+static void loadFilter(HrirFilter& filter, int point, HrirRenderer* r)
+{
+    // Dequantise past the FFT frame; shorter sets are zero-padded
+    float*    ir  = r->work.frame + kHrirFftSize;
+    const int len = r->dataset.irLength();
+    for (int ear = 0; ear < 2; ++ear) {
+        r->dataset.decode(point, ear, ir);
+        memset(ir + len, 0, (kHrirLength - len) * sizeof(float));
+        for (int k = 0; k < kHrirPartitions; ++k) {
+            memcpy(r->work.frame, ir + k * kHrirPartition, kHrirPartition * sizeof(float));
+            memset(r->work.frame + kHrirPartition, 0, kHrirPartition * sizeof(float));
+            r->work.fft.forward(r->work.frame, filter.re[ear][k], filter.im[ear][k]);
+        }
+    }
+}
+
+// Σ_k X[head−k]·H[k] → inverse FFT; the valid half lands in r->work.frame + P
+static void convolveEar(const HrirEmitterState* h, const HrirFilter& filter,
+                        int ear, HrirRenderer* r)
+{
+    float* accRe = r->work.re;
+    float* accIm = r->work.im;
+    memset(accRe, 0, kHrirBins * sizeof(float));
+    memset(accIm, 0, kHrirBins * sizeof(float));
+
+    for (int k = 0; k < kHrirPartitions; ++k) {
+        int          slot = (h->fdlHead - k + kHrirPartitions) % kHrirPartitions;
+        const float* xr   = h->fdlRe[slot];
+        const float* xi   = h->fdlIm[slot];
+        const float* hr   = filter.re[ear][k];
+        const float* hi   = filter.im[ear][k];
+        for (int b = 0; b < kHrirBins; ++b) {
+            accRe[b] += xr[b] * hr[b] - xi[b] * hi[b];
+            accIm[b] += xr[b] * hi[b] + xi[b] * hr[b];
+        }
+    }
+    r->work.fft.inverse(accRe, accIm, r->work.frame);
+}
+
+static void processPartition(HrirEmitterState* h, HrirRenderer* r)
+{
+    r->work.fft.forward(h->inHist, h->fdlRe[h->fdlHead], h->fdlIm[h->fdlHead]);
+    memcpy(h->inHist, h->inHist + kHrirPartition, kHrirPartition * sizeof(float));
+
+    bool fade = false;
+    if (h->targetPoint != h->point) {
+        fade = (h->point >= 0);
+        if (fade)
+            h->slot ^= 1;
+        loadFilter(h->filters[h->slot], h->targetPoint, r);
+        h->point = h->targetPoint;
+    }
+
+    float* out[2] = { h->outL, h->outR };
+    for (int ear = 0; ear < 2; ++ear) {
+        const float* y = r->work.frame + kHrirPartition;
+        if (fade) {
+            // Outgoing filter first, then blend the incoming one over it
+            convolveEar(h, h->filters[h->slot ^ 1], ear, r);
+            memcpy(out[ear], y, kHrirPartition * sizeof(float));
+            convolveEar(h, h->filters[h->slot], ear, r);
+            for (int i = 0; i < kHrirPartition; ++i) {
+                float w = (i + 0.5f) * (1.0f / kHrirPartition);
+                out[ear][i] += w * (y[i] - out[ear][i]);
+            }
+        } else {
+            convolveEar(h, h->filters[h->slot], ear, r);
+            memcpy(out[ear], y, kHrirPartition * sizeof(float));
+        }
+    }
+
+    h->fdlHead = (h->fdlHead + 1) % kHrirPartitions;
+}
+
+// ────────────────────────────────────────────────────────────────
+// Public API
+// ────────────────────────────────────────────────────────────────
+void applyMonoHrirMix(const float* in,
+                      float* outL,
+                      float* outR,
+                      int    numSamples,
+                      float  srcX,
+                      float  srcY,
+                      float  srcZ,
+                      float  gainStart,
+                      float  gainEnd,
+                      bool   overwrite,
+                      SpatialAudioState* state,
+                      HrirEmitterState* hrir,
+                      HrirRenderer* renderer)
+{
+    if (numSamples <= 0)
+        return;
+
+    // ── 1. Block targets ────────────────────────────────────────
+    float dist  = sqrtf(srcX * srcX + srcY * srcY + srcZ * srcZ + 1.0e-6f);
+    float azDeg = atan2f(srcX, srcZ) * (180.0f / M_PI);
+    float elDeg = asinf(clampf(srcY / dist, -1.0f, 1.0f)) * (180.0f / M_PI);
+    const HrtfDataset& dataset = renderer->dataset;
+    hrir->targetPoint = dataset.nearest(azDeg, elDeg);
+
+    // Dataset ITD, interpolated between grid points; > 0 → right ear lags
+    const SpatialRate& rate = *state->rate;
+    float itdT    = dataset.itd(azDeg, elDeg) * (rate.sampleRate / dataset.sampleRate());
+    float itd     = hrir->prevItd;
+    float itdStep = (itdT - itd) / numSamples;
+
+    // Reflection delay and distance ramp across the block; the air
+    // cutoff follows the distance on the control grid
+    DelayBuffer& refl   = state->reflHistory;
+    const bool   reflect = refl.bound();
+    float reflDelay     = state->prevReflDelay;
+    float reflStep      = (reflectionDelay(srcY, rate) - reflDelay) / numSamples;
+    float reflScale     = 0.501187f;                      // −6 dB
+    float airDist       = state->prevDist;
+    float airDistStep   = (dist - airDist) / numSamples;
+    int   phase         = state->controlPhase;
+    const DelayInterp interp = state->interp;
+
+    float gain     = gainStart;
+    float gainStep = (gainEnd - gainStart) / numSamples;
+
+    // ── 2. Process audio buffer ─────────────────────────────────
+    for (int n = 0; n < numSamples; ++n) {
+        // Linear reflection tap, offset back one sample from its position
+        // (the dry path has no bulk delay).  The ITD history keeps up
+        // for a switch back to the parametric path.
+        state->history.write(in[n]);
+        float x     = in[n];
+        float xRefl = 0.0f;
+        reflDelay += reflStep;
+        airDist   += airDistStep;
+        if (reflect) {
+            refl.write(x);
+            xRefl = refl.read<kInterpLinear>(state->reflTapL,
+                                             refl.position<kInterpLinear>(fabsf(reflDelay)), -1) * reflScale;
+        }
+        if (phase == 0)
+            state->airL.setCutoff(airCutoff(airDist), rate);
+        phase = (phase + 1) & (kControlInterval - 1);
+        float dryLP = state->airL.process(x + xRefl);
+
+        // Partition FIFO: previous partition's output out, new input in
+        int   i  = hrir->fill;
+        float yl = hrir->outL[i];
+        float yr = hrir->outR[i];
+        hrir->inHist[kHrirPartition + i] = dryLP;
+        if (++hrir->fill == kHrirPartition) {
+            processPartition(hrir, renderer);
+            hrir->fill = 0;
+        }
+
+        // ITD on the lagging ear (both taps run to stay continuous)
+        itd += itdStep;
+        hrir->earL.write(yl);
+        hrir->earR.write(yr);
+        float left  = hrir->earL.read(hrir->itdTapL, itd < 0.0f ? -itd : 0.0f, interp);
+        float right = hrir->earR.read(hrir->itdTapR, itd > 0.0f ?  itd : 0.0f, interp);
+
+        gain += gainStep;
+        if (overwrite) {
+            outL[n] = left  * gain;
+            outR[n] = right * gain;
+        } else {
+            outL[n] += left  * gain;
+            outR[n] += right * gain;
+        }
+    }
+
+    // ── 3. Save state for next call ─────────────────────────────
+    hrir->prevItd   = itd;
+    state->prevDist = dist;
+    state->prevReflDelay = reflDelay;
+    state->controlPhase  = phase;
+}
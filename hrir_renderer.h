@@ -0,0 +1,106 @@
+// HRIR binaural rendering engine (uniformly partitioned convolution)
+// -------------------------------------------------------------------
+// • Each emitter is convolved with the minimum-phase HRIR pair of the
+//   nearest point of an HrtfDataset.  The dataset's ITD, interpolated
+//   between grid points, is applied separately by fractional taps on
+//   each ear's output, so the filters carry no bulk delay and can be
+//   switched without comb artefacts.
+// • Uniformly partitioned overlap-save: kHrirPartition-sample blocks,
+//   one real FFT per block, a frequency-domain delay line of
+//   kHrirPartitions spectra, two inverse FFTs (one per ear).
+// • When the nearest grid point changes, the new filter pair is
+//   transformed into the idle slot and the next partition is rendered
+//   through both pairs and crossfaded.
+// • Latency is one partition (kHrirPartition samples) plus the one
+//   sample of bulk delay every DelayHistory tap adds.
+
+#pragma once
+
+#include "professional_spatial_audio.h"
+#include "hrtf_dataset.h"
+
+// ────────────────────────────────────────────────────────────────
+// Dimensions
+// ────────────────────────────────────────────────────────────────
+constexpr int kHrirLength     = kHrtfMaxIrLength;             // taps
+constexpr int kHrirPartition  = 64;                           // samples
+constexpr int kHrirFftSize    = 2 * kHrirPartition;
+constexpr int kHrirBins       = kHrirPartition + 1;
+constexpr int kHrirPartitions = kHrirLength / kHrirPartition;
+constexpr int kHrirItdHistory = 128;                          // ≥ ITD at 96 kHz
+
+// ────────────────────────────────────────────────────────────────
+// Shared per-instance renderer: FFT tables and block scratch
+// ────────────────────────────────────────────────────────────────
+struct HrirRenderer {
+    // Sized for dataset synthesis; rendering only uses the first
+    // kHrirFftSize / kHrirBins entries of frame / re / im.
+    HrtfBuildScratch work;
+    HrtfDataset      dataset;
+
+    // Binds the dataset blob (read in place) and readies the FFT.
+    // Fails if the blob is invalid or its HRIRs exceed kHrirLength.
+    bool init(const void* blob, uint32_t bytes);
+};
+
+// ────────────────────────────────────────────────────────────────
+// Per-emitter convolution state
+// ────────────────────────────────────────────────────────────────
+struct HrirFilter {
+    float re[2][kHrirPartitions][kHrirBins];   // [ear][partition][bin]
+    float im[2][kHrirPartitions][kHrirBins];
+};
+
+struct HrirEmitterState {
+    float      inHist[kHrirFftSize];           // overlap-save input frame
+    float      fdlRe[kHrirPartitions][kHrirBins];
+    float      fdlIm[kHrirPartitions][kHrirBins];
+    HrirFilter filters[2];
+    float      outL[kHrirPartition], outR[kHrirPartition];
+
+    int   fdlHead;
+    int   fill;           // samples in the current partition
+    int   slot;           // filters[slot] is current
+    int   point;          // grid point loaded in filters[slot], −1 = none
+    int   targetPoint;
+    float prevItd;        // signed samples, > 0 → right ear lags
+
+    // Convolution output per ear, tapped for the ITD
+    DelayHistory<kHrirItdHistory> earL, earR;
+    DelayTap                      itdTapL, itdTapR;
+
+    HrirEmitterState() { clear(); }
+
+    void clear() {
+        memset(inHist, 0, sizeof(inHist));
+        memset(fdlRe, 0, sizeof(fdlRe));
+        memset(fdlIm, 0, sizeof(fdlIm));
+        memset(outL, 0, sizeof(outL));
+        memset(outR, 0, sizeof(outR));
+        fdlHead = fill = slot = 0;
+        point = targetPoint = -1;
+        prevItd = 0.0f;
+        earL.clear(); earR.clear();
+        itdTapL.clear(); itdTapR.clear();
+    }
+};
+
+// ────────────────────────────────────────────────────────────────
+// Public API
+// ────────────────────────────────────────────────────────────────
+// Same contract as applyMonoSpatialAudioMix.  The input history,
+// reflection tap and air absorption of `state` are shared with the
+// parametric path; `hrir` holds the convolution and ITD state.
+void applyMonoHrirMix(const float* in,
+                      float* outL,
+                      float* outR,
+                      int    numSamples,
+                      float  srcX,
+                      float  srcY,
+                      float  srcZ,
+                      float  gainStart,
+                      float  gainEnd,
+                      bool   overwrite,
+                      SpatialAudioState* state,
+                      HrirEmitterState* hrir,
+                      HrirRenderer* renderer);
@@ -0,0 +1,486 @@
+// Compact HRTF dataset format – see hrtf_dataset.h
+
+#include "hrtf_dataset.h"
+
+static inline uint32_t align4(uint32_t x) { return (x + 3u) & ~3u; }
+
+// ────────────────────────────────────────────────────────────────
+// Half precision
+// ────────────────────────────────────────────────────────────────
+uint16_t hrtfFloatToHalf(float x)
+{
+    uint32_t f;
+    memcpy(&f, &x, sizeof(f));
+    uint32_t sign = (f >> 16) & 0x8000u;
+    int32_t  exp  = static_cast<int32_t>((f >> 23) & 0xffu) - 127 + 15;
+    uint32_t man  = f & 0x7fffffu;
+
+    if (exp >= 31)                          // overflow → ±inf
+        return static_cast<uint16_t>(sign | 0x7c00u);
+    if (exp <= 0) {                         // subnormal or zero
+        if (exp < -10)
+            return static_cast<uint16_t>(sign);
+        man |= 0x800000u;
+        uint32_t shift = static_cast<uint32_t>(14 - exp);
+        uint32_t h     = man >> shift;
+        uint32_t rem   = man & ((1u << shift) - 1u);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rem > halfway || (rem == halfway && (h & 1u)))
+            ++h;
+        return static_cast<uint16_t>(sign | h);
+    }
+    uint32_t h   = sign | (static_cast<uint32_t>(exp) << 10) | (man >> 13);
+    uint32_t rem = man & 0x1fffu;
+    if (rem > 0x1000u || (rem == 0x1000u && (h & 1u)))
+        ++h;                                // may carry into the exponent
+    return static_cast<uint16_t>(h);
+}
+
+float hrtfHalfToFloat(uint16_t h)
+{
+    uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+    uint32_t exp  = (h >> 10) & 0x1fu;
+    uint32_t man  = h & 0x3ffu;
+    uint32_t f;
+    if (exp == 0) {
+        if (man == 0) {
+            f = sign;
+        } else {                            // renormalise subnormal
+            exp = 127 - 15 + 1;
+            while (!(man & 0x400u)) { man <<= 1; --exp; }
+            f = sign | (exp << 23) | ((man & 0x3ffu) << 13);
+        }
+    } else if (exp == 31) {
+        f = sign | 0x7f800000u | (man << 13);
+    } else {
+        f = sign | ((exp - 15 + 127) << 23) | (man << 13);
+    }
+    float x;
+    memcpy(&x, &f, sizeof(x));
+    return x;
+}
+
+// ────────────────────────────────────────────────────────────────
+// Reader
+// ────────────────────────────────────────────────────────────────
+bool HrtfDataset::bind(const void* blob, uint32_t bytes)
+{
+    hdr = nullptr;
+    const HrtfHeader* h = static_cast<const HrtfHeader*>(blob);
+    if (!blob || (reinterpret_cast<uintptr_t>(blob) & 3u) || bytes < sizeof(HrtfHeader))
+        return false;
+    if (h->magic != kHrtfMagic || h->version != kHrtfVersion || h->totalBytes > bytes)
+        return false;
+    if (h->format > kHrtfFloat16 || h->irLength == 0 || h->irLength > kHrtfMaxIrLength)
+        return false;
+    if (h->numRings == 0 || h->numRings > kHrtfMaxRings || h->numPoints == 0)
+        return false;
+
+    // Every section 4-byte aligned and inside totalBytes, in 64-bit
+    // arithmetic so that no offset + size can wrap
+    const int      e      = (h->flags & kHrtfFlagSymmetric) ? 1 : 2;
+    const uint64_t points = h->numPoints;
+    const struct {
+        uint32_t offset;
+        uint64_t size;
+    } sections[] = {
+        { h->ringsOffset,   h->numRings * uint64_t(sizeof(HrtfRing)) },
+        { h->elevLutOffset, kHrtfElevLutSize },
+        { h->itdOffset,     points * sizeof(int16_t) },
+        { h->scaleOffset,   points * e * sizeof(float) },
+        { h->irOffset,      points * e * h->irLength * sizeof(uint16_t) },
+    };
+    for (const auto& sec : sections) {
+        if ((sec.offset & 3u) || uint64_t(sec.offset) + sec.size > h->totalBytes)
+            return false;
+    }
+
+    const uint8_t* base = static_cast<const uint8_t*>(blob);
+    rings   = reinterpret_cast<const HrtfRing*>(base + h->ringsOffset);
+    elevLut = base + h->elevLutOffset;
+    itds    = reinterpret_cast<const int16_t*>(base + h->itdOffset);
+    scales  = reinterpret_cast<const float*>(base + h->scaleOffset);
+    samples = reinterpret_cast<const uint16_t*>(base + h->irOffset);
+    ears    = e;
+
+    // The grid must tile the point range exactly
+    int next = 0;
+    for (int r = 0; r < h->numRings; ++r) {
+        if (rings[r].firstPoint != next || rings[r].numAz == 0)
+            return false;
+        next += rings[r].numAz;
+    }
+    if (next != h->numPoints)
+        return false;
+
+    // lowerRing() indexes rings[] with the table directly
+    for (int i = 0; i < kHrtfElevLutSize; ++i) {
+        if (elevLut[i] >= h->numRings)
+            return false;
+    }
+
+    hdr = h;
+    return true;
+}
+
+int HrtfDataset::lowerRing(float elDeg) const
+{
+    elDeg  = clampf(elDeg, -90.0f, 90.0f);
+    int r  = elevLut[static_cast<int>(floorf(elDeg)) + 90];
+    // Rings are ≥ 1° apart, so at most one lies inside this degree
+    if (r + 1 < hdr->numRings && elDeg >= rings[r + 1].elevation)
+        ++r;
+    return r;
+}
+
+// Lower azimuth index on ring r and the fraction towards the next one
+int HrtfDataset::azimuthIndex(const HrtfRing& r, float azDeg, float& frac) const
+{
+    float pos = azDeg * (r.numAz / 360.0f);
+    float fl  = floorf(pos);
+    frac      = pos - fl;
+    int   i   = static_cast<int>(fl) % r.numAz;
+    return (i < 0) ? i + r.numAz : i;
+}
+
+int HrtfDataset::nearest(float azDeg, float elDeg) const
+{
+    int r = lowerRing(elDeg);
+    if (r + 1 < hdr->numRings) {
+        float mid = 0.5f * (rings[r].elevation + rings[r + 1].elevation);
+        if (elDeg >= mid)
+            ++r;
+    }
+    float frac;
+    int   i = azimuthIndex(rings[r], azDeg, frac);
+    if (frac >= 0.5f)
+        i = (i + 1) % rings[r].numAz;
+    return rings[r].firstPoint + i;
+}
+
+void HrtfDataset::neighbours(float azDeg, float elDeg, int point[4], float weight[4]) const
+{
+    int   r0 = lowerRing(elDeg);
+    int   r1 = r0;
+    float t  = 0.0f;
+    if (elDeg > rings[r0].elevation && r0 + 1 < hdr->numRings) {
+        r1 = r0 + 1;
+        t  = (elDeg - rings[r0].elevation) / (rings[r1].elevation - rings[r0].elevation);
+    }
+
+    const int   ringIdx[2] = { r0, r1 };
+    const float ringW[2]   = { 1.0f - t, t };
+    for (int k = 0; k < 2; ++k) {
+        const HrtfRing& ring = rings[ringIdx[k]];
+        float frac;
+        int   i = azimuthIndex(ring, azDeg, frac);
+        point[2 * k]      = ring.firstPoint + i;
+        point[2 * k + 1]  = ring.firstPoint + (i + 1) % ring.numAz;
+        weight[2 * k]     = ringW[k] * (1.0f - frac);
+        weight[2 * k + 1] = ringW[k] * frac;
+    }
+}
+
+int HrtfDataset::mirror(int point) const
+{
+    int r = 0;
+    while (r + 1 < hdr->numRings && rings[r + 1].firstPoint <= point)
+        ++r;
+    const HrtfRing& ring = rings[r];
+    int i = point - ring.firstPoint;
+    return ring.firstPoint + (ring.numAz - i) % ring.numAz;
+}
+
+void HrtfDataset::decode(int point, int ear, float* out) const
+{
+    if (ears == 1 && ear == 1) {
+        point = mirror(point);
+        ear   = 0;
+    }
+    const int       ir  = point * ears + ear;
+    const int       n   = hdr->irLength;
+    const uint16_t* src = samples + ir * n;
+    if (hdr->format == kHrtfFloat16) {
+        for (int i = 0; i < n; ++i)
+            out[i] = hrtfHalfToFloat(src[i]);
+    } else {
+        const float s = scales[ir];
+        for (int i = 0; i < n; ++i)
+            out[i] = static_cast<int16_t>(src[i]) * s;
+    }
+}
+
+float HrtfDataset::itd(float azDeg, float elDeg) const
+{
+    int   p[4];
+    float w[4];
+    neighbours(azDeg, elDeg, p, w);
+    return (itds[p[0]] * w[0] + itds[p[1]] * w[1] + itds[p[2]] * w[2] + itds[p[3]] * w[3])
+           * kHrtfItdUnit;
+}
+
+// ────────────────────────────────────────────────────────────────
+// Writer
+// ────────────────────────────────────────────────────────────────
+void HrtfGrid::rings(float elevMin, float elevMax, float elevStep, int horizAz)
+{
+    numRings = 0;
+    for (float el = elevMin; el <= elevMax + 1.0e-3f && numRings < kHrtfMaxRings; el += elevStep) {
+        int n = 2 * static_cast<int>(floorf(0.5f * horizAz * cosf(el * (M_PI / 180.0f)) + 0.5f));
+        elevation[numRings] = el;
+        numAz[numRings]     = (n < 1) ? 1 : n;
+        ++numRings;
+    }
+}
+
+int HrtfGrid::numPoints() const
+{
+    int n = 0;
+    for (int r = 0; r < numRings; ++r)
+        n += numAz[r];
+    return n;
+}
+
+struct HrtfBlobLayout {
+    uint32_t rings, elevLut, itd, scale, ir, total;
+};
+
+static HrtfBlobLayout blobLayout(const HrtfGrid& grid, const HrtfWriteOptions& opts)
+{
+    const uint32_t points = grid.numPoints();
+    const uint32_t irs    = points * (opts.symmetric ? 1 : 2);
+    HrtfBlobLayout l;
+    l.rings   = sizeof(HrtfHeader);
+    l.elevLut = l.rings + grid.numRings * sizeof(HrtfRing);
+    l.itd     = align4(l.elevLut + kHrtfElevLutSize);
+    l.scale   = align4(l.itd + points * sizeof(int16_t));
+    l.ir      = l.scale + irs * sizeof(float);
+    l.total   = align4(l.ir + irs * opts.irLength * sizeof(uint16_t));
+    return l;
+}
+
+uint32_t hrtfBlobBytes(const HrtfGrid& grid, const HrtfWriteOptions& opts)
+{
+    return blobLayout(grid, opts).total;
+}
+
+void hrtfMinimumPhase(HrtfBuildScratch& s, float* ir, int length)
+{
+    constexpr int kFadeLen = 16;
+    float* re  = s.re;
+    float* im  = s.im;
+    float* buf = s.frame;
+
+    // Real cepstrum of ln|H|, folded onto its causal half
+    for (int k = 0; k < kHrtfBuildBins; ++k)
+        im[k] = 0.0f;
+    s.fft.inverse(re, im, buf);
+    for (int n = 1; n < kHrtfBuildFft / 2; ++n)
+        buf[n] *= 2.0f;
+    for (int n = kHrtfBuildFft / 2 + 1; n < kHrtfBuildFft; ++n)
+        buf[n] = 0.0f;
+    s.fft.forward(buf, re, im);
+
+    for (int k = 0; k < kHrtfBuildBins; ++k) {
+        float m = expf(re[k]);
+        float p = im[k];
+        re[k]   = m * cosf(p);
+        im[k]   = m * sinf(p);
+    }
+    s.fft.inverse(re, im, buf);
+
+    for (int n = 0; n < length; ++n)
+        ir[n] = buf[n];
+    const int fade = (length < 2 * kFadeLen) ? length / 2 : kFadeLen;
+    for (int n = 0; n < fade; ++n) {
+        float w = 0.5f + 0.5f * cosf(M_PI * (n + 1) / (fade + 1));
+        ir[length - fade + n] *= w;
+    }
+}
+
+uint32_t hrtfWriteBlob(void* blob, const HrtfGrid& grid, const HrtfWriteOptions& opts,
+                       HrtfSource& source, HrtfBuildScratch& scratch)
+{
+    const HrtfBlobLayout l    = blobLayout(grid, opts);
+    const int            ears = opts.symmetric ? 1 : 2;
+    uint8_t*             base = static_cast<uint8_t*>(blob);
+    memset(base, 0, l.total);
+
+    HrtfHeader* h  = reinterpret_cast<HrtfHeader*>(base);
+    h->magic       = kHrtfMagic;
+    h->version     = kHrtfVersion;
+    h->format      = opts.format;
+    h->sampleRate  = opts.sampleRate;
+    h->totalBytes  = l.total;
+    h->irLength    = static_cast<uint16_t>(opts.irLength);
+    h->numRings    = static_cast<uint16_t>(grid.numRings);
+    h->numPoints   = static_cast<uint16_t>(grid.numPoints());
+    h->flags       = opts.symmetric ? kHrtfFlagSymmetric : 0;
+    h->ringsOffset   = l.rings;
+    h->elevLutOffset = l.elevLut;
+    h->itdOffset     = l.itd;
+    h->scaleOffset   = l.scale;
+    h->irOffset      = l.ir;
+    strncpy(h->name, opts.name, sizeof(h->name) - 1);
+
+    HrtfRing* rings = reinterpret_cast<HrtfRing*>(base + l.rings);
+    int       first = 0;
+    for (int r = 0; r < grid.numRings; ++r) {
+        rings[r].elevation  = grid.elevation[r];
+        rings[r].numAz      = static_cast<uint16_t>(grid.numAz[r]);
+        rings[r].firstPoint = static_cast<uint16_t>(first);
+        first += grid.numAz[r];
+    }
+
+    uint8_t* lut = base + l.elevLut;
+    for (int d = 0; d < kHrtfElevLutSize; ++d) {
+        int r = 0;
+        while (r + 1 < grid.numRings && grid.elevation[r + 1] <= d - 90)
+            ++r;
+        lut[d] = static_cast<uint8_t>(r);
+    }
+
+    int16_t*  itds    = reinterpret_cast<int16_t*>(base + l.itd);
+    float*    scales  = reinterpret_cast<float*>(base + l.scale);
+    uint16_t* samples = reinterpret_cast<uint16_t*>(base + l.ir);
+    float     ir[kHrtfMaxIrLength];
+    float*    mag     = scratch.im;        // free until hrtfMinimumPhase
+
+    scratch.fft.init(kHrtfBuildFft);
+    for (int r = 0; r < grid.numRings; ++r) {
+        const float el = grid.elevation[r];
+        for (int a = 0; a < grid.numAz[r]; ++a) {
+            const int   p  = rings[r].firstPoint + a;
+            const float az = a * 360.0f / grid.numAz[r];
+
+            // Symmetric sets average each point with its mirror image
+            float itd = source.itd(source.context, az, el);
+            if (opts.symmetric)
+                itd = 0.5f * (itd - source.itd(source.context, -az, el));
+            itds[p] = static_cast<int16_t>(clampf(floorf(itd / kHrtfItdUnit + 0.5f),
+                                                  -32768.0f, 32767.0f));
+
+            for (int ear = 0; ear < ears; ++ear) {
+                source.magnitude(source.context, az, el, ear, mag);
+                for (int k = 0; k < kHrtfBuildBins; ++k)
+                    scratch.re[k] = logf(fmaxf(mag[k], 1.0e-4f));
+                if (opts.symmetric) {
+                    source.magnitude(source.context, -az, el, 1, mag);
+                    for (int k = 0; k < kHrtfBuildBins; ++k)
+                        scratch.re[k] = 0.5f * (scratch.re[k] + logf(fmaxf(mag[k], 1.0e-4f)));
+                }
+                hrtfMinimumPhase(scratch, ir, opts.irLength);
+
+                const int ix  = p * ears + ear;
+                uint16_t* dst = samples + ix * opts.irLength;
+                if (opts.format == kHrtfFloat16) {
+                    scales[ix] = 1.0f;
+                    for (int n = 0; n < opts.irLength; ++n)
+                        dst[n] = hrtfFloatToHalf(ir[n]);
+                } else {
+                    float peak = 1.0e-9f;
+                    for (int n = 0; n < opts.irLength; ++n)
+                        peak = fmaxf(peak, fabsf(ir[n]));
+                    const float scale = peak / 32767.0f;
+                    scales[ix] = scale;
+                    for (int n = 0; n < opts.irLength; ++n) {
+                        float q = floorf(ir[n] / scale + 0.5f);
+                        dst[n]  = static_cast<uint16_t>(static_cast<int16_t>(clampf(q, -32767.0f, 32767.0f)));
+                    }
+                }
+            }
+        }
+    }
+    return l.total;
+}
+
+// ────────────────────────────────────────────────────────────────
+// Built-in spherical-head model
+// ────────────────────────────────────────────────────────────────
+static constexpr float kHeadRadius = 0.0875f;                  // m
+
+// Analogue peaking section: gain g at f0, unity far from it
+static float peakMagnitude(float f, float f0, float q, float g)
+{
+    float d  = f0 * f0 - f * f;
+    float bw = f * f0 / q;
+    return sqrtf((d * d + g * g * bw * bw) / (d * d + bw * bw));
+}
+
+// Magnitude at the given ear for a source at (az, el) radians, +az = left
+static float headMagnitude(float f, float az, float el, int ear)
+{
+    // Brown & Duda single-pole/zero head shadow
+    constexpr float kAlphaMin = 0.1f;
+    constexpr float kThetaMin = 150.0f * M_PI / 180.0f;
+    float lateral = (ear == 0) ? sinf(az) : -sinf(az);
+    float cosInc  = clampf(lateral * cosf(el), -1.0f, 1.0f);
+    float theta   = acosf(cosInc);
+    float alpha   = (1.0f + 0.5f * kAlphaMin)
+                  + (1.0f - 0.5f * kAlphaMin) * cosf(theta / kThetaMin * M_PI);
+    float wr      = M_PI * f * kHeadRadius / kSpeedOfSound;    // ω / 2ω0
+    float mag     = sqrtf((1.0f + alpha * alpha * wr * wr) / (1.0f + wr * wr));
+
+    // Pinna notch, tracking elevation like the parametric path
+    float elevN = el * (2.0f / M_PI);
+    mag *= peakMagnitude(f, kNotchFc + kNotchSpan * elevN, 4.0f, 0.2f);
+
+    // Concha resonance
+    mag *= peakMagnitude(f, 4500.0f, 1.5f, 1.6f);
+
+    // Torso shadow for sources below the horizon
+    if (elevN < 0.0f)
+        mag *= 1.0f + 0.4f * elevN * (f * f / (f * f + 1.0e6f));
+
+    return mag;
+}
+
+static void sphericalMagnitude(void* context, float azDeg, float elDeg, int ear, float* mag)
+{
+    const float rate = *static_cast<float*>(context);
+    const float az   = azDeg * (M_PI / 180.0f);
+    const float el   = elDeg * (M_PI / 180.0f);
+    for (int k = 0; k < kHrtfBuildBins; ++k)
+        mag[k] = headMagnitude(static_cast<float>(k) * rate / kHrtfBuildFft, az, el, ear);
+}
+
+// Woodworth: (a/c)(θ + sin θ) for lateral angle θ
+static float sphericalItd(void* context, float azDeg, float elDeg)
+{
+    const float rate   = *static_cast<float*>(context);
+    const float sinLat = sinf(azDeg * (M_PI / 180.0f)) * cosf(elDeg * (M_PI / 180.0f));
+    return kHeadRadius / kSpeedOfSound * (asinf(sinLat) + sinLat) * rate;
+}
+
+HrtfSource sphericalHeadSource(float* sampleRate)
+{
+    HrtfSource s;
+    s.context   = sampleRate;
+    s.magnitude = sphericalMagnitude;
+    s.itd       = sphericalItd;
+    return s;
+}
+
+void hrtfSphericalGrid(HrtfGrid& grid)
+{
+    grid.rings(-40.0f, 80.0f, 20.0f, 24);
+}
+
+uint32_t hrtfSphericalBlobBytes()
+{
+    HrtfGrid grid;
+    hrtfSphericalGrid(grid);
+    return hrtfBlobBytes(grid, HrtfWriteOptions());
+}
+
+uint32_t hrtfSynthesiseSpherical(void* blob, HrtfBuildScratch& scratch, float sampleRate)
+{
+    HrtfGrid grid;
+    hrtfSphericalGrid(grid);
+    HrtfWriteOptions opts;
+    opts.name       = "Spherical";
+    opts.sampleRate = static_cast<uint32_t>(sampleRate);
+    float      rate   = sampleRate;
+    HrtfSource source = sphericalHeadSource(&rate);
+    return hrtfWriteBlob(blob, grid, opts, source, scratch);
+}
@@ -0,0 +1,183 @@
+// Compact HRTF dataset format ("TEHR")
+// -------------------------------------------------------------------
+// • One self-describing little-endian blob: header, ring grid,
+//   elevation lookup, ITD table, per-IR scales, quantised
+//   minimum-phase HRIRs.  Every section is 4-byte aligned, so a blob
+//   compiled into the plugin (or synthesised into DRAM) is read in
+//   place – HrtfDataset::bind() only checks it and sets pointers.
+// • Grid: rings of constant elevation, each with equally spaced
+//   azimuths starting at 0°.  A 1°-resolution elevation table gives the
+//   ring directly, so nearest-point and bilinear neighbour lookups are
+//   O(1) whatever the grid density.
+// • HRIRs are minimum phase; the interaural delay lives in the ITD
+//   table and is applied by the renderer's fractional delay lines.
+// • Symmetric sets store the left ear only; the right ear of a point
+//   is the left ear of its mirror (azimuth negated).
+// • The writer is shared by the plugin's built-in spherical-head model
+//   and the host converter (tools/hrtf_convert.cpp).
+
+#pragma once
+
+#include "professional_spatial_audio.h"
+#include "real_fft.h"
+
+constexpr uint32_t kHrtfMagic       = 0x52484554u;    // "TEHR" in file order
+constexpr uint16_t kHrtfVersion     = 1;
+constexpr int      kHrtfMaxRings    = 64;
+constexpr int      kHrtfMaxIrLength = 128;     // = kHrirLength
+constexpr int      kHrtfElevLutSize = 184;     // −90…+90 in 1° steps, padded
+constexpr float    kHrtfItdUnit     = 1.0f / 256.0f;   // samples per ITD LSB
+
+enum HrtfSampleFormat : uint16_t {
+    kHrtfInt16,          // Q15 × per-IR scale
+    kHrtfFloat16,        // IEEE half, scale unused (1.0)
+};
+
+enum : uint16_t {
+    kHrtfFlagSymmetric = 1u << 0,
+};
+
+// ────────────────────────────────────────────────────────────────
+// On-disk layout
+// ────────────────────────────────────────────────────────────────
+struct HrtfHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t format;         // HrtfSampleFormat
+    uint32_t sampleRate;
+    uint32_t totalBytes;
+    uint16_t irLength;
+    uint16_t numRings;
+    uint16_t numPoints;
+    uint16_t flags;
+    uint32_t ringsOffset;    // HrtfRing[numRings], ascending elevation
+    uint32_t elevLutOffset;  // uint8_t[kHrtfElevLutSize]: ring at or below each degree
+    uint32_t itdOffset;      // int16_t[numPoints], kHrtfItdUnit, > 0 → right ear lags
+    uint32_t scaleOffset;    // float[numPoints × ears]
+    uint32_t irOffset;       // uint16_t[numPoints × ears × irLength]
+    char     name[16];
+    uint32_t reserved;
+};
+
+struct HrtfRing {
+    float    elevation;      // degrees
+    uint16_t numAz;          // azimuth k at k·360/numAz degrees, +az = left
+    uint16_t firstPoint;
+};
+
+// ────────────────────────────────────────────────────────────────
+// Read-only view of a blob
+// ────────────────────────────────────────────────────────────────
+class HrtfDataset {
+public:
+    // Validates the blob and points into it; no data is copied.
+    bool bind(const void* blob, uint32_t bytes);
+    bool valid() const { return hdr != nullptr; }
+
+    int   irLength()   const { return hdr->irLength; }
+    int   numPoints()  const { return hdr->numPoints; }
+    int   numRings()   const { return hdr->numRings; }
+    float sampleRate() const { return static_cast<float>(hdr->sampleRate); }
+    const char* name() const { return hdr->name; }
+    const HrtfRing& ring(int r) const { return rings[r]; }
+
+    // Nearest grid point to (azimuth, elevation) in degrees
+    int nearest(float azDeg, float elDeg) const;
+
+    // The four points bracketing (az, el) – two azimuths on each of the
+    // two enclosing rings – with bilinear weights summing to 1.  This is
+    // the ring-grid equivalent of a triangulated lookup.
+    void neighbours(float azDeg, float elDeg, int point[4], float weight[4]) const;
+
+    // Point with the azimuth negated (same ring)
+    int mirror(int point) const;
+
+    // Dequantises one ear (0 = left, 1 = right) into out[irLength()]
+    void decode(int point, int ear, float* out) const;
+
+    // Interaural delay in samples at sampleRate(); > 0 → right ear lags
+    float itd(int point) const { return itds[point] * kHrtfItdUnit; }
+    float itd(float azDeg, float elDeg) const;
+
+private:
+    int lowerRing(float elDeg) const;
+    int azimuthIndex(const HrtfRing& r, float azDeg, float& frac) const;
+
+    const HrtfHeader* hdr   = nullptr;
+    const HrtfRing*   rings = nullptr;
+    const uint8_t*    elevLut = nullptr;
+    const int16_t*    itds  = nullptr;
+    const float*      scales = nullptr;
+    const uint16_t*   samples = nullptr;
+    int               ears  = 2;
+};
+
+// ────────────────────────────────────────────────────────────────
+// Writer
+// ────────────────────────────────────────────────────────────────
+struct HrtfGrid {
+    int   numRings = 0;
+    float elevation[kHrtfMaxRings];      // ascending, ≥ 1° apart
+    int   numAz[kHrtfMaxRings];
+
+    // Rings every elevStep from elevMin to elevMax, with the azimuth
+    // count scaled from horizAz by cos(elevation) and rounded to even
+    void rings(float elevMin, float elevMax, float elevStep, int horizAz);
+    int  numPoints() const;
+};
+
+constexpr int kHrtfBuildFft  = RealFft::kMaxSize;
+constexpr int kHrtfBuildBins = kHrtfBuildFft / 2 + 1;
+
+// FFT and buffers for minimum-phase reconstruction (≈10 KB); the HRIR
+// renderer reuses them for its own block processing.
+struct HrtfBuildScratch {
+    RealFft fft;
+    float   frame[kHrtfBuildFft];
+    float   re[kHrtfBuildBins];
+    float   im[kHrtfBuildBins];
+};
+
+// Source of dataset content.  magnitude() fills |H| on the
+// kHrtfBuildBins-point linear grid (bin k at k·sampleRate/kHrtfBuildFft)
+// for one ear of a direction; itd() returns its ITD in samples.
+struct HrtfSource {
+    void* context;
+    void  (*magnitude)(void* context, float azDeg, float elDeg, int ear, float* mag);
+    float (*itd)(void* context, float azDeg, float elDeg);
+};
+
+struct HrtfWriteOptions {
+    int              irLength   = kHrtfMaxIrLength;
+    HrtfSampleFormat format     = kHrtfInt16;
+    bool             symmetric  = true;
+    uint32_t         sampleRate = static_cast<uint32_t>(kSampleRate);
+    const char*      name       = "";
+};
+
+uint32_t hrtfBlobBytes(const HrtfGrid& grid, const HrtfWriteOptions& opts);
+
+// Builds a complete blob (hrtfBlobBytes() bytes, 4-byte aligned) from
+// magnitudes via the real cepstrum.  Returns the byte count.
+uint32_t hrtfWriteBlob(void* blob, const HrtfGrid& grid, const HrtfWriteOptions& opts,
+                       HrtfSource& source, HrtfBuildScratch& scratch);
+
+// Minimum-phase response from scratch.re[0…kHrtfBuildBins) = ln|H|,
+// tapered to `length` taps in ir
+void hrtfMinimumPhase(HrtfBuildScratch& scratch, float* ir, int length);
+
+// ────────────────────────────────────────────────────────────────
+// Built-in spherical-head model
+// ────────────────────────────────────────────────────────────────
+// Brown & Duda head shadow, elevation-dependent pinna notch, concha
+// resonance and torso shadow; Woodworth ITD.  context → float sample rate.
+HrtfSource sphericalHeadSource(float* sampleRate);
+
+// Built-in model synthesised on the default grid with default options
+void     hrtfSphericalGrid(HrtfGrid& grid);
+uint32_t hrtfSphericalBlobBytes();
+uint32_t hrtfSynthesiseSpherical(void* blob, HrtfBuildScratch& scratch, float sampleRate);
+
+// IEEE half-precision conversion (round to nearest even)
+uint16_t hrtfFloatToHalf(float x);
+float    hrtfHalfToFloat(uint16_t h);
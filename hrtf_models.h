@@ -0,0 +1,27 @@
+// Head models available to the HRIR render mode
+// -------------------------------------------------------------------
+// • Entry 0 is the built-in spherical-head model, synthesised once
+//   into the factory's static DRAM by initialise() and shared.  An
+//   instance synthesises its own copy into DRAM at construct() (≈32 KB)
+//   only if initialise() never ran or the sample rate has changed since.
+// • Further entries are TEHR blobs compiled into the plugin and read in
+//   place, costing no DRAM.  To add one, convert it with
+//       hrtf_convert --sofa subject.sofa --name Subject --header hrtf/subject.h
+//   (which defines kHrtfSubject), include the header here and append
+//   { "Subject", kHrtfSubject, sizeof(kHrtfSubject) }.
+
+#pragma once
+
+#include <cstdint>
+
+struct HrtfModel {
+    const char* name;
+    const void* blob;       // nullptr → synthesised spherical head
+    uint32_t    bytes;
+};
+
+static const HrtfModel kHrtfModels[] = {
+    { "Spherical", nullptr, 0 },
+};
+
+constexpr int kNumHrtfModels = sizeof(kHrtfModels) / sizeof(kHrtfModels[0]);
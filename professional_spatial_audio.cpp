@@ -1,67 +1,52 @@
 // Professional Spatial Audio Implementation for ARM Cortex-M7  (v2.5)
 // -------------------------------------------------------------------
-// • No call to atan2f (or fast approximation).  Uses sinAz = x / √(x²+z²).
-// • Externalisation cues, smoothing, dual-delay ITD remain from v2.3.
+// • No call to atan2f (or fast approximation).  Uses sinAz = x / √(x²+z²),
+//   or takes sin(azimuth) directly through the polar entry point.
+// • Trig, pow and sqrt come from fast_math.h (bounded-error polynomials).
+// • Externalisation cues and smoothing remain from v2.3.
+// • ITD and floor reflection are fractional taps on the input history
+//   (the reflection on a longer copy in DRAM, sized for the furthest
+//   source); both ears are tapped every sample, so the ITD has no
+//   discontinuity when a source crosses the median plane, and both
+//   delays ramp every sample.
+// • Biquad coefficients and the air-absorption cutoff move on a fixed
+//   8-sample grid that runs across calls, not per call, so the output
+//   does not depend on how the host cuts its blocks.
+// • Three levels of detail (full, reduced, pan) with crossfaded
+//   transitions, chosen per emitter by the plugin's CPU budget.
+// • Head-shadow shelf and pinna notch as smoothed biquads, or as TPT
+//   SVFs whose cutoff and gain ramp every sample (SpatialFilter).
 // • Public API unchanged.
 
-#include <cmath>
-#include <cstdint>
-#include <cstring>      // memset
+#include "professional_spatial_audio.h"
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846f
-#endif
-
-// ────────────────────────────────────────────────────────────────
-// Constants & helpers
-// ────────────────────────────────────────────────────────────────
-constexpr float kSampleRate   = 48000.0f;
-constexpr float kInvSR        = 1.0f / kSampleRate;
-constexpr float kSpeedOfSound = 343.0f;            // m / s
+// ───────── Sample-rate constants ────────────────────────────────
+extern const SpatialRate kDefaultSpatialRate = {
+    kSampleRate, 1.0f / kSampleRate, 0.45f * kSampleRate,
+    0.0005f * kSampleRate, kSampleRate / kSpeedOfSound, 0.999f,
+    static_cast<int>(0.01f * kSampleRate), 0.0984914f,
+};
 
-static inline float clampf(float x, float lo, float hi)
+void SpatialRate::set(float fs)
 {
-    return (x < lo) ? lo : (x > hi) ? hi : x;
+    sampleRate      = fs;
+    invSampleRate   = 1.0f / fs;
+    maxFilterFc     = 0.45f * fs;
+    itdSamples      = 0.0005f * fs;
+    samplesPerMetre = fs / kSpeedOfSound;
+    coeffSmooth     = fastExp2(-1.4434169e-3f * kSampleRate / fs);   // 0.999^(48 k / fs)
+    detailFade      = static_cast<int>(0.01f * fs);
+    const float w   = M_PI * kShelfFc / fs;
+    shelfTan        = fastSin(w) / fastCos(w);
 }
 
-// ────────────────────────────────────────────────────────────────
-// Biquad with coefficient smoothing
-// ────────────────────────────────────────────────────────────────
-class Biquad {
-public:
-    Biquad() { clear(); }
-
-    float process(float x) {
-        float y = b0 * x + z1;
-        z1 = b1 * x - a1 * y + z2;
-        z2 = b2 * x - a2 * y;
-        return y;
-    }
-
-    void setCoeffs(float _b0, float _b1, float _b2,
-                   float _a0, float _a1, float _a2)
-    {
-        constexpr float kSmooth = 0.999f;     // ≈5 ms time-constant
-        b0 = kSmooth * b0 + (1.0f - kSmooth) * (_b0 / _a0);
-        b1 = kSmooth * b1 + (1.0f - kSmooth) * (_b1 / _a0);
-        b2 = kSmooth * b2 + (1.0f - kSmooth) * (_b2 / _a0);
-        a1 = kSmooth * a1 + (1.0f - kSmooth) * (_a1 / _a0);
-        a2 = kSmooth * a2 + (1.0f - kSmooth) * (_a2 / _a0);
-    }
-
-    void clear() { b0 = 1; b1 = b2 = a1 = a2 = z1 = z2 = 0; }
-
-private:
-    float b0{}, b1{}, b2{}, a1{}, a2{}, z1{}, z2{};
-};
-
 // ───────── Filter builders ──────────────────────────────────────
-static inline void setNotch(Biquad& f, float fc, float Q = 8.0f)
+void notchCoeffs(const SpatialRate& rate, float fc, float Q, BiquadCoeffs& c)
 {
-    fc = clampf(fc, 200.0f, kSampleRate * 0.45f);
-    float w0    = 2.0f * M_PI * fc * kInvSR;
-    float cosw0 = cosf(w0);
-    float alpha = sinf(w0) / (2.0f * Q);
+    fc = clampf(fc, 200.0f, rate.maxFilterFc);
+    float w0    = 2.0f * M_PI * fc * rate.invSampleRate;
+    float cosw0 = fastCos(w0);
+    float alpha = fastSin(w0) / (2.0f * Q);
 
     float b0 =  1.0f;
     float b1 = -2.0f * cosw0;
@@ -70,19 +55,20 @@ static inline void setNotch(Biquad& f, float fc, float Q = 8.0f)
     float a1 = -2.0f * cosw0;
     float a2 =  1.0f - alpha;
 
-    f.setCoeffs(b0, b1, b2, a0, a1, a2);
+    c = { b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0 };
 }
 
-static inline void setHighShelf(Biquad& f, float fc, float dBgain)
+void highShelfCoeffs(const SpatialRate& rate, float fc, float dBgain, BiquadCoeffs& c)
 {
-    fc = clampf(fc, 300.0f, kSampleRate * 0.45f);
+    fc = clampf(fc, 300.0f, rate.maxFilterFc);
 
-    float A     = powf(10.0f, dBgain * 0.05f);
-    float w0    = 2.0f * M_PI * fc * kInvSR;
-    float cosw0 = cosf(w0);
-    float sinw0 = sinf(w0);
+    float sqrtA = fastDbToGain(0.5f * dBgain);  // √A, A = 10^(dB/20)
+    float A     = sqrtA * sqrtA;
+    float w0    = 2.0f * M_PI * fc * rate.invSampleRate;
+    float cosw0 = fastCos(w0);
+    float sinw0 = fastSin(w0);
     float alpha = sinw0 * 0.70710678f;         // sin/2 * √2
-    float beta  = sqrtf(A) * alpha;
+    float beta  = sqrtA * alpha;
 
     float b0 =      A * ((A + 1) + (A - 1) * cosw0 + 2 * beta);
     float b1 = -2 * A * ((A - 1) + (A + 1) * cosw0);
@@ -91,77 +77,626 @@ static inline void setHighShelf(Biquad& f, float fc, float dBgain)
     float a1 =  2 *     ((A - 1) - (A + 1) * cosw0);
     float a2 =          (A + 1) - (A - 1) * cosw0 - 2 * beta;
 
-    f.setCoeffs(b0, b1, b2, a0, a1, a2);
+    c = { b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0 };
+}
+
+// A = 10^(dB/40): low shelf gain 1, high gain A²; g scaled by √A keeps
+// the mid-gain point at kShelfFc.  Q = 1/√2 as in highShelfCoeffs.
+void highShelfSvf(const SpatialRate& rate, float dBgain, SvfParams& p)
+{
+    const float sqrtA = fastDbToGain(0.25f * dBgain);
+    const float A     = sqrtA * sqrtA;
+    const float k     = 1.41421356f;
+    p = { rate.shelfTan * sqrtA, k, A * A, k * (1.0f - A) * A, 1.0f - A * A };
+}
+
+void notchSvf(const SpatialRate& rate, float fc, SvfParams& p)
+{
+    fc = clampf(fc, 200.0f, rate.maxFilterFc);
+    const float w = M_PI * fc * rate.invSampleRate;
+    const float k = 1.0f / kNotchQ;
+    p = { fastSin(w) / fastCos(w), k, 1.0f, -k, 0.0f };
 }
 
 // ────────────────────────────────────────────────────────────────
-// One-pole low-pass (air absorption)
+// Coefficient tables
 // ────────────────────────────────────────────────────────────────
-class OnePoleLP {
-public:
-    OnePoleLP() : alpha(0.0f), y1(0.0f) {}
-
-    void setCutoff(float fc) {
-        fc = clampf(fc, 50.0f, 0.45f * kSampleRate);
-        float rc = 1.0f / (2.0f * M_PI * fc);
-        alpha = kInvSR / (rc + kInvSR);
-    }
+void SpatialCoeffTable::init(void* storage, int points, const SpatialRate& rate)
+{
+    numPoints = clampPoints(points);
+    stride    = 1;
+    halfSpan  = 0.5f * static_cast<float>(numPoints - 1);
+
+    auto* shelfOut = static_cast<BiquadCoeffs*>(storage);
+    auto* notchOut = shelfOut + numPoints;
 
-    float process(float x) {
-        y1 += alpha * (x - y1);
-        return y1;
+    for (int i = 0; i < numPoints; ++i) {
+        float x = -1.0f + static_cast<float>(i) / halfSpan;      // −1…+1
+        highShelfCoeffs(rate, kShelfFc, kShelfMaxDb * x, shelfOut[i]);
+        notchCoeffs(rate, kNotchFc + kNotchSpan * x, kNotchQ, notchOut[i]);
     }
 
-private:
-    float alpha, y1;
-};
+    shelfGrid = shelfOut;
+    notchGrid = notchOut;
+}
+
+// Grid point i of a coarser table sits at −1 + i / halfSpan, which is
+// exactly point i · stride of the finer one
+bool SpatialCoeffTable::view(const SpatialCoeffTable& full, int points)
+{
+    if (full.numPoints < kMinPoints || !viewable(full.numPoints, points))
+        return false;
+    numPoints = clampPoints(points);
+    stride    = (full.numPoints - 1) / (numPoints - 1) * full.stride;
+    halfSpan  = 0.5f * static_cast<float>(numPoints - 1);
+    shelfGrid = full.shelfGrid;
+    notchGrid = full.notchGrid;
+    return true;
+}
 
 // ────────────────────────────────────────────────────────────────
-// Fractional delay line (linear) – 512 samples
+// Kernel – shared by the scratch-buffer and fused-mix entry points
 // ────────────────────────────────────────────────────────────────
-class DelayLine {
-public:
-    DelayLine() : writeIdx(0) { memset(buf, 0, sizeof(buf)); }
+enum SpatialWrite {
+    kWriteStore,        // out  = y · gain
+    kWriteAccumulate,   // out += y · gain
+};
+
+// Stage mask the kernel is specialised on (SpatialQuality)
+enum : unsigned {
+    kStagesReflection = 1u,
+    kStagesNotch      = 2u,
+    kStagesAll        = kStagesReflection | kStagesNotch,
+};
 
-    float process(float x, float delaySamples)
-    {
-        buf[writeIdx] = x;
+// Shelf (and notch) coefficients for sinAz / elevN, from the table when
+// there is one
+static inline void shelfCoeffs(const SpatialAudioState* state, float sinAz, BiquadCoeffs& c)
+{
+    if (const SpatialCoeffTable* table = state->coeffTable)
+        table->shelf(sinAz, c);
+    else
+        highShelfCoeffs(*state->rate, kShelfFc, kShelfMaxDb * sinAz, c);
+}
 
-        float readPos = static_cast<float>(writeIdx) - delaySamples;
-        if (readPos < 0) readPos += kMax;
+static inline void notchCoeffsAt(const SpatialAudioState* state, float elevN, BiquadCoeffs& c)
+{
+    if (const SpatialCoeffTable* table = state->coeffTable)
+        table->notch(elevN, c);
+    else
+        notchCoeffs(*state->rate, kNotchFc + kNotchSpan * elevN, kNotchQ, c);
+}
 
-        int   i0   = static_cast<int>(readPos) & kMask;
-        int   i1   = (i0 + 1) & kMask;
-        float frac = readPos - static_cast<int>(readPos);
-        float y    = buf[i0] * (1.0f - frac) + buf[i1] * frac;
+bool setSpatialDetail(SpatialAudioState* state, SpatialDetail detail)
+{
+    if (state->fadeRemaining > 0)
+        return false;
+    if (detail == state->detail)
+        return true;
+
+    // Richer tier: restart what the old one skipped (lower enum = richer)
+    BiquadCoeffs c;
+    if (state->detail == kDetailPan) {
+        shelfCoeffs(state,  state->prevSinAz, c); state->shelfL.snap(c);
+        shelfCoeffs(state, -state->prevSinAz, c); state->shelfR.snap(c);
+        state->svfShelfL.clear();
+        state->svfShelfR.clear();
+        state->airL.clear();
+        state->airR.clear();
+        state->reflTapL.clear();
+        state->reflTapR.clear();
+    }
+    if (detail == kDetailFull) {
+        notchCoeffsAt(state, state->prevElevN, c);
+        state->notchL.snap(c);
+        state->notchR.snap(c);
+        state->svfNotchL.clear();
+        state->svfNotchR.clear();
+    }
+
+    state->fadeFrom      = state->detail;
+    state->detail        = detail;
+    state->fadeRemaining = state->rate->detailFade;
+    return true;
+}
+
+static bool qualityHasNotch(SpatialQuality q)
+{
+    return q == kQualityFull || q == kQualityNoReflection;
+}
+
+void setSpatialQuality(SpatialAudioState* state, SpatialQuality quality)
+{
+    if (!qualityHasNotch(state->quality) && qualityHasNotch(quality)) {
+        BiquadCoeffs c;
+        notchCoeffsAt(state, state->prevElevN, c);
+        state->notchL.snap(c);
+        state->notchR.snap(c);
+        state->svfNotchL.clear();
+        state->svfNotchR.clear();
+    }
+    state->quality = quality;
+    setSpatialKernel(state);
+}
+
+// Per-block values shared by the two loop structures: ramps of the
+// polar position and the reflection delay, SVF parameter ramps and the
+// tier crossfade
+struct SpatialBlock {
+    float sinAz, elevN, dist, reflDelay;
+    float sinAzStep, elevStep, distStep, reflStep;
+    float reflScale;
+
+    SvfParams shelfL, shelfR, notch, shelfStepL, shelfStepR, notchStep;
+    SvfGains  shelfGainsL, shelfGainsR;
+
+    float mix, mixStep;
+    bool  fading, fadeToPan;
+};
+
+template <SpatialDetail kTier, SpatialFilter kFilter, unsigned kStages>
+static inline void beginSpatialBlock(SpatialBlock& b, const SpatialPolar& target,
+                                     const int numSamples, SpatialAudioState* state)
+{
+    // ── 1. Target parameters (block) ────────────────────────────
+    const float sinAzT = target.sinAz;                            // −1…+1
+    const float elevNT = target.elevN;                            // −1…+1
+    const float distT  = target.dist;
+
+    // ── 2. Linear ramp across this block ───────────────────────
+    b.sinAzStep = (sinAzT - state->prevSinAz) / numSamples;
+    b.elevStep  = (elevNT - state->prevElevN) / numSamples;
+    b.distStep  = (distT  - state->prevDist ) / numSamples;
+
+    b.sinAz = state->prevSinAz;
+    b.elevN = state->prevElevN;
+    b.dist  = state->prevDist;
+
+    // Early reflection delay, ramped like the position (the air cutoff
+    // follows the ramped distance on the control grid)
+    const SpatialRate& rate = *state->rate;
+    b.reflDelay = state->prevReflDelay;
+    b.reflStep  = (reflectionDelay(target.height, rate) - b.reflDelay) / numSamples;
+    b.reflScale = 0.501187f;                              // −6 dB
+
+    // Reduced: one shelf update per block toward the block-end position,
+    // smoothed as much as numSamples / 8 per-sample-rate updates would be
+    if (kTier == kDetailReduced && kFilter == kFilterBiquad) {
+        float smooth = 1.0f - (1.0f - rate.coeffSmooth) * numSamples * 0.125f;
+        smooth = (smooth > 0.0f) ? smooth : 0.0f;
+        BiquadCoeffs c;
+        shelfCoeffs(state,  sinAzT, c); state->shelfL.setNormalized(c, smooth);
+        shelfCoeffs(state, -sinAzT, c); state->shelfR.setNormalized(c, smooth);
+    }
+
+    // SVF: parameters ramp from the block-start position to the target
+    // (Reduced: the shelf sits at the target for the whole block)
+    b.shelfL = b.shelfR = b.notch = b.shelfStepL = b.shelfStepR = b.notchStep = SvfParams{};
+    b.shelfGainsL = b.shelfGainsR = SvfGains{};
+    if (kFilter == kFilterSvf && kTier != kDetailPan) {
+        SvfParams endL, endR;
+        highShelfSvf(rate, kShelfMaxDb *  sinAzT, endL);
+        highShelfSvf(rate, kShelfMaxDb * -sinAzT, endR);
+        if (kTier == kDetailFull) {
+            highShelfSvf(rate, kShelfMaxDb *  b.sinAz, b.shelfL);
+            highShelfSvf(rate, kShelfMaxDb * -b.sinAz, b.shelfR);
+            b.shelfStepL = b.shelfL.stepTo(endL, numSamples);
+            b.shelfStepR = b.shelfR.stepTo(endR, numSamples);
+            if (kStages & kStagesNotch) {
+                SvfParams endN;
+                notchSvf(rate, kNotchFc + kNotchSpan * b.elevN, b.notch);
+                notchSvf(rate, kNotchFc + kNotchSpan * elevNT, endN);
+                b.notchStep = b.notch.stepTo(endN, numSamples);
+            }
+        } else {
+            b.shelfL = endL;
+            b.shelfR = endR;
+            b.shelfGainsL = svfGains(b.shelfL);
+            b.shelfGainsR = svfGains(b.shelfR);
+        }
+    }
 
-        writeIdx = (writeIdx + 1) & kMask;
-        return y;
+    // Tier crossfade: mix is the weight of this (richer) tier's output
+    // against the cheaper tier's; a fade ending mid-block finishes at
+    // the block end
+    SpatialDetail cheap = kTier;
+    b.mix     = 1.0f;
+    b.mixStep = 0.0f;
+    if (state->fadeRemaining > 0) {
+        const float len  = static_cast<float>(rate.detailFade);
+        float       from = 1.0f - state->fadeRemaining / len;            // new tier's weight
+        float       to   = 1.0f - (state->fadeRemaining - numSamples) / len;
+        to = (to < 1.0f) ? to : 1.0f;
+        bool upgrade = state->detail == kTier;
+        cheap     = upgrade ? state->fadeFrom : state->detail;
+        b.mix     = upgrade ? from : 1.0f - from;
+        b.mixStep = (upgrade ? to - from : from - to) / numSamples;
+        state->fadeRemaining -= numSamples;
     }
+    b.fading    = cheap != kTier;
+    b.fadeToPan = cheap == kDetailPan;
+}
 
-private:
-    static constexpr int kMax  = 512;
-    static constexpr int kMask = kMax - 1;
+// ── 3a. Fused loop: control and audio work interleaved per sample ──
+template <SpatialWrite kWrite, DelayInterp kInterp, SpatialDetail kTier, SpatialFilter kFilter,
+          unsigned kStages>
+static inline void renderFused(const float* in, float* outL, float* outR, const int numSamples,
+                               float gain, const float gainStep, SpatialBlock& b,
+                               SpatialAudioState* state)
+{
+    const SpatialRate& rate = *state->rate;
+    auto& hist = state->history;
+    auto& refl = state->reflHistory;
+    const bool reflect = refl.bound();
+    constexpr bool kReflect = (kStages & kStagesReflection) != 0;
+    constexpr bool kNotch   = kTier == kDetailFull && (kStages & kStagesNotch) != 0;
+    int phase = state->controlPhase;
+    for (int n = 0; n < numSamples; ++n) {
+        b.sinAz += b.sinAzStep;
+        b.elevN += b.elevStep;
+        b.dist  += b.distStep;
+        b.reflDelay += b.reflStep;
+        const float sinAz = b.sinAz;
+        const bool control = phase == 0;
+        phase = (phase + 1) & (kControlInterval - 1);
+
+        // ITD on the far ear: source on the left (sinAz > 0) → right lags
+        float itdL = rate.itdSamples * (sinAz < 0.0f ? -sinAz : 0.0f);
+        float itdR = rate.itdSamples * (sinAz > 0.0f ?  sinAz : 0.0f);
+        float ildL = 1.0f + 0.25f * sinAz;                // ±3 dB broadband
+        float ildR = 1.0f - 0.25f * sinAz;
 
-    float buf[kMax]{};
-    int   writeIdx;
+        hist.write(in[n]);
+        if (reflect)
+            refl.write(in[n]);
+        DelayPos posL = hist.template position<kInterp>(itdL);
+        DelayPos posR = hist.template position<kInterp>(itdR);
+        float left  = hist.template read<kInterp>(state->tapL, posL);
+        float right = hist.template read<kInterp>(state->tapR, posR);
+        float reflL = 0.0f, reflR = 0.0f;
+        if (kTier != kDetailPan && kReflect && reflect) {
+            reflL = refl.template read<kInterp>(state->reflTapL, refl.template position<kInterp>(itdL + fabsf(b.reflDelay)));
+            reflR = refl.template read<kInterp>(state->reflTapR, refl.template position<kInterp>(itdR + fabsf(b.reflDelay)));
+        }
+        TINEAR_PROFILE_MARK(state->profile, kStageDelay);
+
+        if (kTier == kDetailPan) {
+            left  *= ildL;
+            right *= ildR;
+        } else {
+            float panL = left  * ildL;
+            float panR = right * ildR;
+
+            // Early reflection per ear, then air absorption and ILD
+            if (kReflect) {
+                left  += reflL * b.reflScale;
+                right += reflR * b.reflScale;
+            }
+            if (control) {
+                state->airL.setCutoff(airCutoff(b.dist), rate);
+                state->airR.copyCutoff(state->airL);
+            }
+            left  = state->airL.process(left)  * ildL;
+            right = state->airR.process(right) * ildR;
+
+            // Biquad: update filter coefficients on the control grid
+            if (kFilter == kFilterBiquad && kTier == kDetailFull && control) {
+                TINEAR_PROFILE_MARK(state->profile, kStageFilter);
+                BiquadCoeffs c;
+                shelfCoeffs(state,  sinAz, c); state->shelfL.setNormalized(c, rate.coeffSmooth);
+                shelfCoeffs(state, -sinAz, c); state->shelfR.setNormalized(c, rate.coeffSmooth);
+                if (kNotch) {
+                    notchCoeffsAt(state, b.elevN, c);
+                    state->notchL.setNormalized(c, rate.coeffSmooth);
+                    state->notchR.setNormalized(c, rate.coeffSmooth);
+                }
+                TINEAR_PROFILE_MARK(state->profile, kStageCoeffs);
+            }
+
+            // Head-shadow shelf (+ pinna notch)
+            if (kFilter == kFilterSvf && kTier == kDetailFull) {
+                b.shelfL.advance(b.shelfStepL);
+                b.shelfR.advance(b.shelfStepR);
+                left  = state->svfShelfL.process(left, b.shelfL);
+                right = state->svfShelfR.process(right, b.shelfR);
+            } else if (kFilter == kFilterSvf) {
+                left  = state->svfShelfL.process(left, b.shelfL, b.shelfGainsL);
+                right = state->svfShelfR.process(right, b.shelfR, b.shelfGainsR);
+            } else {
+                left  = state->shelfL.process(left);
+                right = state->shelfR.process(right);
+            }
+            float shelfOnlyL = left, shelfOnlyR = right;
+            if (kNotch && kFilter == kFilterSvf) {
+                b.notch.advance(b.notchStep);
+                const SvfGains a = svfGains(b.notch);
+                left  = state->svfNotchL.process(left, b.notch, a);
+                right = state->svfNotchR.process(right, b.notch, a);
+            } else if (kNotch) {
+                left  = state->notchL.process(left);
+                right = state->notchR.process(right);
+            }
+
+            if (b.fading) {
+                float cheapL = b.fadeToPan ? panL : shelfOnlyL;
+                float cheapR = b.fadeToPan ? panR : shelfOnlyR;
+                b.mix += b.mixStep;
+                left  = cheapL + b.mix * (left  - cheapL);
+                right = cheapR + b.mix * (right - cheapR);
+            }
+        }
+        TINEAR_PROFILE_MARK(state->profile, kStageFilter);
+
+        // Output gain ramp, stored or mixed into the destination
+        gain += gainStep;
+        if (kWrite == kWriteAccumulate) {
+            outL[n] += left  * gain;
+            outR[n] += right * gain;
+        } else {
+            outL[n] = left  * gain;
+            outR[n] = right * gain;
+        }
+        TINEAR_PROFILE_MARK(state->profile, kStageMix);
+    }
+    state->controlPhase = phase;
+}
+
+// ── 3b. Two passes per sub-block of kControlChunk samples ──────
+// Sub-blocks follow the control grid, so a block that starts mid-grid
+// begins with a short one.  The control pass advances the position,
+// reflection, gain and crossfade ramps and writes the tap positions,
+// ILD, gain and crossfade weight to arrays, updating the biquad
+// coefficients and air cutoff at a grid point as the fused loop does;
+// the audio pass then runs the delay, filter and mix chain with no
+// position-dependent branches.  The SVF parameter ramps are branch-free
+// and stay in the audio pass: held in registers they cost less than a
+// round trip through the arrays.  Same arithmetic in the same order, so
+// the output is bit-identical to the fused loop.
+constexpr int kControlChunk = kControlInterval;
+
+struct SpatialControl {
+    DelayPos  posL[kControlChunk], posR[kControlChunk];
+    DelayPos  reflPosL[kControlChunk], reflPosR[kControlChunk];
+    float     ildL[kControlChunk], ildR[kControlChunk];
+    float     gain[kControlChunk], mix[kControlChunk];
 };
 
+template <SpatialWrite kWrite, DelayInterp kInterp, SpatialDetail kTier, SpatialFilter kFilter,
+          unsigned kStages>
+static inline void renderTwoPass(const float* in, float* outL, float* outR, const int numSamples,
+                                 float gain, const float gainStep, SpatialBlock& b,
+                                 SpatialAudioState* state)
+{
+    const SpatialRate& rate = *state->rate;
+    auto& hist = state->history;
+    auto& refl = state->reflHistory;
+    const bool reflect = refl.bound();
+    constexpr bool kReflect = (kStages & kStagesReflection) != 0;
+    constexpr bool kNotch   = kTier == kDetailFull && (kStages & kStagesNotch) != 0;
+    SpatialControl ctl;
+
+    int phase = state->controlPhase;
+    for (int start = 0, count; start < numSamples; start += count) {
+        count = kControlChunk - phase;
+        count = (numSamples - start < count) ? numSamples - start : count;
+        const bool control = phase == 0;
+        phase = (phase + count) & (kControlInterval - 1);
+
+        // Control pass
+        for (int i = 0; i < count; ++i) {
+            b.sinAz += b.sinAzStep;
+            b.elevN += b.elevStep;
+            b.dist  += b.distStep;
+            b.reflDelay += b.reflStep;
+            const float sinAz = b.sinAz;
+
+            float itdL = rate.itdSamples * (sinAz < 0.0f ? -sinAz : 0.0f);
+            float itdR = rate.itdSamples * (sinAz > 0.0f ?  sinAz : 0.0f);
+            ctl.ildL[i] = 1.0f + 0.25f * sinAz;
+            ctl.ildR[i] = 1.0f - 0.25f * sinAz;
+            ctl.posL[i] = hist.template position<kInterp>(itdL);
+            ctl.posR[i] = hist.template position<kInterp>(itdR);
+            if (kTier != kDetailPan && kReflect && reflect) {
+                ctl.reflPosL[i] = refl.template position<kInterp>(itdL + fabsf(b.reflDelay));
+                ctl.reflPosR[i] = refl.template position<kInterp>(itdR + fabsf(b.reflDelay));
+            }
+
+            if (kTier != kDetailPan && control && i == 0) {
+                state->airL.setCutoff(airCutoff(b.dist), rate);
+                state->airR.copyCutoff(state->airL);
+            }
+            if (kFilter == kFilterBiquad && kTier == kDetailFull && control && i == 0) {
+                BiquadCoeffs c;
+                shelfCoeffs(state,  sinAz, c); state->shelfL.setNormalized(c, rate.coeffSmooth);
+                shelfCoeffs(state, -sinAz, c); state->shelfR.setNormalized(c, rate.coeffSmooth);
+                if (kNotch) {
+                    notchCoeffsAt(state, b.elevN, c);
+                    state->notchL.setNormalized(c, rate.coeffSmooth);
+                    state->notchR.setNormalized(c, rate.coeffSmooth);
+                }
+            }
+
+            if (kTier != kDetailPan && b.fading)
+                b.mix += b.mixStep;
+            ctl.mix[i] = b.mix;
+            gain += gainStep;
+            ctl.gain[i] = gain;
+        }
+        TINEAR_PROFILE_MARK(state->profile, kStageCoeffs);
+
+        // Audio pass
+        const float* src = in + start;
+        float* dstL = outL + start;
+        float* dstR = outR + start;
+        for (int i = 0; i < count; ++i) {
+            hist.write(src[i]);
+            if (reflect)
+                refl.write(src[i]);
+            float left  = hist.template read<kInterp>(state->tapL, ctl.posL[i]);
+            float right = hist.template read<kInterp>(state->tapR, ctl.posR[i]);
+
+            if (kTier == kDetailPan) {
+                left  *= ctl.ildL[i];
+                right *= ctl.ildR[i];
+            } else {
+                float reflL = 0.0f, reflR = 0.0f;
+                if (kReflect && reflect) {
+                    reflL = refl.template read<kInterp>(state->reflTapL, ctl.reflPosL[i]);
+                    reflR = refl.template read<kInterp>(state->reflTapR, ctl.reflPosR[i]);
+                }
+                float panL = left  * ctl.ildL[i];
+                float panR = right * ctl.ildR[i];
+
+                if (kReflect) {
+                    left  += reflL * b.reflScale;
+                    right += reflR * b.reflScale;
+                }
+                left  = state->airL.process(left)  * ctl.ildL[i];
+                right = state->airR.process(right) * ctl.ildR[i];
+
+                if (kFilter == kFilterSvf && kTier == kDetailFull) {
+                    b.shelfL.advance(b.shelfStepL);
+                    b.shelfR.advance(b.shelfStepR);
+                    left  = state->svfShelfL.process(left, b.shelfL);
+                    right = state->svfShelfR.process(right, b.shelfR);
+                } else if (kFilter == kFilterSvf) {
+                    left  = state->svfShelfL.process(left, b.shelfL, b.shelfGainsL);
+                    right = state->svfShelfR.process(right, b.shelfR, b.shelfGainsR);
+                } else {
+                    left  = state->shelfL.process(left);
+                    right = state->shelfR.process(right);
+                }
+                float shelfOnlyL = left, shelfOnlyR = right;
+                if (kNotch && kFilter == kFilterSvf) {
+                    b.notch.advance(b.notchStep);
+                    const SvfGains a = svfGains(b.notch);
+                    left  = state->svfNotchL.process(left, b.notch, a);
+                    right = state->svfNotchR.process(right, b.notch, a);
+                } else if (kNotch) {
+                    left  = state->notchL.process(left);
+                    right = state->notchR.process(right);
+                }
+
+                if (b.fading) {
+                    float cheapL = b.fadeToPan ? panL : shelfOnlyL;
+                    float cheapR = b.fadeToPan ? panR : shelfOnlyR;
+                    left  = cheapL + ctl.mix[i] * (left  - cheapL);
+                    right = cheapR + ctl.mix[i] * (right - cheapR);
+                }
+            }
+
+            if (kWrite == kWriteAccumulate) {
+                dstL[i] += left  * ctl.gain[i];
+                dstR[i] += right * ctl.gain[i];
+            } else {
+                dstL[i] = left  * ctl.gain[i];
+                dstR[i] = right * ctl.gain[i];
+            }
+        }
+        TINEAR_PROFILE_MARK(state->profile, kStageFilter);
+    }
+    state->controlPhase = phase;
+}
+
+template <SpatialWrite kWrite, DelayInterp kInterp, SpatialDetail kTier, SpatialFilter kFilter,
+          unsigned kStages>
+static inline void renderMonoSpatialAudio(const float* in,
+                                          float* outL,
+                                          float* outR,
+                                          const int    numSamples,
+                                          const SpatialPolar& target,
+                                          float        gain,
+                                          const float  gainStep,
+                                          SpatialAudioState* state)
+{
+    SpatialBlock b;
+    beginSpatialBlock<kTier, kFilter, kStages>(b, target, numSamples, state);
+    TINEAR_PROFILE_MARK(state->profile, kStageCoeffs);
+
+    // The fused loop is kept for A/B runs of the full chain only
+    if (kStages != kStagesAll || state->kernel == kKernelTwoPass)
+        renderTwoPass<kWrite, kInterp, kTier, kFilter, kStages>(in, outL, outR, numSamples,
+                                                                gain, gainStep, b, state);
+    else
+        renderFused<kWrite, kInterp, kTier, kFilter, kStages>(in, outL, outR, numSamples,
+                                                              gain, gainStep, b, state);
+
+    // ── 4. Save smoothed state for next call ────────────────────
+    state->prevSinAz = b.sinAz;
+    state->prevElevN = b.elevN;
+    state->prevDist  = b.dist;
+    state->prevReflDelay = b.reflDelay;
+}
+
 // ────────────────────────────────────────────────────────────────
-// Per-emitter spatial audio state structure
+// Specialisations
 // ────────────────────────────────────────────────────────────────
-struct SpatialAudioState {
-    Biquad    notchL, notchR, shelfL, shelfR;
-    OnePoleLP airLP;
-    DelayLine delayL, delayR;
-    DelayLine reflDelay;
-    
-    float prevSinAz;      // smoothed sin(azimuth)
-    float prevElevN;      // smoothed elevation norm
-    float prevDist;
-    
-    SpatialAudioState() : prevSinAz(0.0f), prevElevN(0.0f), prevDist(1.0f) {}
-};
+// The interpolation, filter and stage set are fixed per emitter and
+// resolved to a function pointer by setSpatialKernel; only the tier,
+// which the scheduler may change every block, is dispatched per call.
+// Reduced has no notch and Pan neither stage: they're instantiated with
+// those bits set, so stage sets that differ only there share them and
+// the full set's are the same as before the stages could be left out.
+template <SpatialWrite kWrite, DelayInterp kInterp, SpatialFilter kFilter, unsigned kStages>
+static void renderSpecialised(const float* in, float* outL, float* outR,
+                              int numSamples, const SpatialPolar& target,
+                              float gain, float gainStep, SpatialAudioState* state)
+{
+    // A crossfade runs at the richer of its two tiers
+    SpatialDetail tier = state->detail;
+    if (state->fadeRemaining > 0 && state->fadeFrom < tier)
+        tier = state->fadeFrom;
+
+    switch (tier) {
+    case kDetailReduced:
+        renderMonoSpatialAudio<kWrite, kInterp, kDetailReduced, kFilter, kStages | kStagesNotch>(
+            in, outL, outR, numSamples, target, gain, gainStep, state);
+        break;
+    case kDetailPan:
+        renderMonoSpatialAudio<kWrite, kInterp, kDetailPan, kFilterBiquad, kStagesAll>(
+            in, outL, outR, numSamples, target, gain, gainStep, state);
+        break;
+    default:
+        renderMonoSpatialAudio<kWrite, kInterp, kDetailFull, kFilter, kStages>(
+            in, outL, outR, numSamples, target, gain, gainStep, state);
+        break;
+    }
+}
+
+template <SpatialWrite kWrite, DelayInterp kInterp, SpatialFilter kFilter>
+static SpatialRenderFn spatialKernel(SpatialQuality quality)
+{
+    switch (quality) {
+    case kQualityNoNotch:      return renderSpecialised<kWrite, kInterp, kFilter, kStagesReflection>;
+    case kQualityNoReflection: return renderSpecialised<kWrite, kInterp, kFilter, kStagesNotch>;
+    case kQualityDirect:       return renderSpecialised<kWrite, kInterp, kFilter, 0u>;
+    default:                   return renderSpecialised<kWrite, kInterp, kFilter, kStagesAll>;
+    }
+}
+
+template <SpatialWrite kWrite, DelayInterp kInterp>
+static SpatialRenderFn spatialKernel(SpatialFilter filter, SpatialQuality quality)
+{
+    if (filter == kFilterSvf)
+        return spatialKernel<kWrite, kInterp, kFilterSvf>(quality);
+    return spatialKernel<kWrite, kInterp, kFilterBiquad>(quality);
+}
+
+template <SpatialWrite kWrite>
+static SpatialRenderFn spatialKernel(DelayInterp interp, SpatialFilter filter, SpatialQuality quality)
+{
+    switch (interp) {
+    case kInterpLagrange3: return spatialKernel<kWrite, kInterpLagrange3>(filter, quality);
+    case kInterpThiran:    return spatialKernel<kWrite, kInterpThiran>(filter, quality);
+    default:               return spatialKernel<kWrite, kInterpLinear>(filter, quality);
+    }
+}
+
+void setSpatialKernel(SpatialAudioState* state)
+{
+    state->renderStore      = spatialKernel<kWriteStore>(state->interp, state->filter, state->quality);
+    state->renderAccumulate = spatialKernel<kWriteAccumulate>(state->interp, state->filter, state->quality);
+}
 
 // ────────────────────────────────────────────────────────────────
 // Public API (modified to accept per-emitter state)
@@ -176,81 +711,40 @@ void applyMonoSpatialAudio(const float* in,
                            const float  srcZ,
                            SpatialAudioState* state)
 {
-    // ── 1. Compute target parameters (block) ───────────────────
-    float horizDist = sqrtf(srcX * srcX + srcZ * srcZ) + 1.0e-6f; // avoid /0
-    float sinAzT    = clampf(srcX / horizDist, -1.0f, 1.0f);      // −1…+1
-    float distT     = sqrtf(srcX * srcX + srcY * srcY + srcZ * srcZ + 1.0e-6f);
-    float elevT     = asinf(srcY / distT);                        // −π/2…+π/2
-    float elevNT    = elevT * (2.0f / M_PI);                      // −1…+1
-
-    // ── 2. Linear ramp across this block ───────────────────────
-    float sinAzStep = (sinAzT - state->prevSinAz) / numSamples;
-    float elevStep  = (elevNT - state->prevElevN) / numSamples;
-    float distStep  = (distT  - state->prevDist ) / numSamples;
-
-    float sinAz = state->prevSinAz;
-    float elevN = state->prevElevN;
-    float dist  = state->prevDist;
-
-    // Early reflection + LPF set once per block
-    float reflDelaySamp = fabsf(srcY) / kSpeedOfSound * kSampleRate;
-    float reflScale     = 0.501187f;                      // −6 dB
-    float lpCut         = 15000.0f - 1000.0f * (distT - 0.5f);
-    state->airLP.setCutoff(clampf(lpCut, 5000.0f, 15000.0f));
-
-    // ── 3. Process audio buffer ─────────────────────────────────
-    for (int n = 0; n < numSamples; ++n) {
-        sinAz += sinAzStep;
-        elevN += elevStep;
-        dist  += distStep;
-
-        // ITD delay (positive on lagging ear)
-        float itdSamples = 0.0005f * fabsf(sinAz) * kSampleRate; // 0…24
-
-        // Early reflection
-        float x = in[n];
-        float xRefl = state->reflDelay.process(x, reflDelaySamp) * reflScale;
-        float dry = x + xRefl;
-
-        // Air absorption
-        float dryLP = state->airLP.process(dry);
-
-        // ITD routing
-        float left, right;
-        if (sinAz >= 0.0f) {                // source on left → left ear lags
-            left  = state->delayL.process(dryLP,  itdSamples);
-            right = dryLP;
-        } else {                            // source on right
-            left  = dryLP;
-            right = state->delayR.process(dryLP,  itdSamples);
-        }
-
-        // ILD (broadband ±3 dB)
-        float ildL = 1.0f + 0.25f * sinAz;
-        float ildR = 1.0f - 0.25f * sinAz;
-        left  *= ildL;
-        right *= ildR;
-
-        // Update filter coefficients every 8 samples
-        if ((n & 7) == 0) {
-            setHighShelf(state->shelfL, 1500.0f,  8.0f * sinAz);
-            setHighShelf(state->shelfR, 1500.0f, -8.0f * sinAz);
-            float notchFc = 8000.0f + 2500.0f * elevN;
-            setNotch(state->notchL, notchFc);
-            setNotch(state->notchR, notchFc);
-        }
-
-        // Head-shadow shelf + pinna notch
-        left  = state->notchL.process(state->shelfL.process(left));
-        right = state->notchR.process(state->shelfR.process(right));
+    state->renderStore(in, outL, outR, numSamples, spatialPolar(srcX, srcY, srcZ), 1.0f, 0.0f, state);
+}
 
-        outL[n] = left;
-        outR[n] = right;
-    }
+extern "C"
+void applyMonoSpatialAudioMix(const float* in,
+                              float* outL,
+                              float* outR,
+                              const int    numSamples,
+                              const float  srcX,
+                              const float  srcY,
+                              const float  srcZ,
+                              const float  gainStart,
+                              const float  gainEnd,
+                              const bool   overwrite,
+                              SpatialAudioState* state)
+{
+    const SpatialPolar target = spatialPolar(srcX, srcY, srcZ);
+    applyMonoSpatialAudioPolar(in, outL, outR, numSamples, &target,
+                               gainStart, gainEnd, overwrite, state);
+}
 
-    // ── 4. Save smoothed state for next call ────────────────────
-    state->prevSinAz = sinAz;
-    state->prevElevN = elevN;
-    state->prevDist  = dist;
+extern "C"
+void applyMonoSpatialAudioPolar(const float* in,
+                                float* outL,
+                                float* outR,
+                                const int    numSamples,
+                                const SpatialPolar* target,
+                                const float  gainStart,
+                                const float  gainEnd,
+                                const bool   overwrite,
+                                SpatialAudioState* state)
+{
+    const float gainStep = (gainEnd - gainStart) / numSamples;
+    const SpatialRenderFn render = overwrite ? state->renderStore : state->renderAccumulate;
+    render(in, outL, outR, numSamples, *target, gainStart, gainStep, state);
 }
 
@@ -0,0 +1,788 @@
+// Professional Spatial Audio – shared declarations
+// -------------------------------------------------------------------
+// • DSP building blocks and per-emitter state used by the engine in
+//   professional_spatial_audio.cpp, the plugin in th_tinear.cpp and
+//   the host-side tools under bench/.
+// • Everything here is header-inline so SpatialAudioState can be
+//   placement-constructed by whichever translation unit owns it.
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>      // memset
+
+#include "fast_math.h"
+#include "tinear_profile.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846f
+#endif
+
+// ────────────────────────────────────────────────────────────────
+// Constants & helpers
+// ────────────────────────────────────────────────────────────────
+constexpr float kSampleRate   = 48000.0f;          // reference / default rate
+constexpr float kSpeedOfSound = 343.0f;            // m / s
+constexpr float kMaxSampleRate = 96000.0f;         // delay buffers are sized for it
+
+// Head-shadow shelf and pinna notch voicing (shared by the exact
+// filter builders and the coefficient tables)
+constexpr float kShelfFc      = 1500.0f;           // Hz
+constexpr float kShelfMaxDb   = 8.0f;              // at |sinAz| = 1
+constexpr float kNotchFc      = 8000.0f;           // Hz at elevN = 0
+constexpr float kNotchSpan    = 2500.0f;           // Hz per unit elevN
+constexpr float kNotchQ       = 8.0f;
+
+static inline float clampf(float x, float lo, float hi)
+{
+    return (x < lo) ? lo : (x > hi) ? hi : x;
+}
+
+// ────────────────────────────────────────────────────────────────
+// Sample-rate dependent constants
+// ────────────────────────────────────────────────────────────────
+// Computed once per rate change and shared by every emitter, so the
+// kernels never derive anything from the rate per sample or per block.
+struct SpatialRate {
+    float sampleRate;          // Hz
+    float invSampleRate;
+    float maxFilterFc;         // builder cutoff ceiling, 0.45·fs
+    float itdSamples;          // parametric ITD at |sinAz| = 1 (0.5 ms)
+    float samplesPerMetre;     // reflection path delay, fs / c
+    float coeffSmooth;         // per 8-sample coefficient update; same
+                               // time constant as 0.999 at 48 kHz
+    int   detailFade;          // level-of-detail crossfade, 10 ms
+    float shelfTan;            // tan(π·kShelfFc / fs), the SVF shelf prewarp
+
+    void set(float fs);
+};
+
+// kSampleRate constants; used by states not bound to a plugin instance
+extern const SpatialRate kDefaultSpatialRate;
+
+// Control grid: biquad coefficients and the air-absorption cutoff move
+// every kControlInterval samples, counted across calls
+// (SpatialAudioState::controlPhase), so they change on the same samples
+// whatever the host block size
+constexpr int kControlInterval = 8;
+
+// Air-absorption cutoff for a source dist metres away
+static inline float airCutoff(float dist)
+{
+    return clampf(15000.0f - 1000.0f * (dist - 0.5f), 5000.0f, 15000.0f);
+}
+
+// Floor-reflection path delay, in samples, signed by the source height.
+// Kernels ramp the signed value and tap its magnitude, so a source
+// crossing the listener's plane folds on the right sample rather than
+// at a block boundary.
+static inline float reflectionDelay(float height, const SpatialRate& rate)
+{
+    return height * rate.samplesPerMetre;
+}
+
+// Source position as the kernels consume it.  The plugin's controls are
+// polar already, so it fills this directly; the Cartesian entry points
+// convert with spatialPolar().
+struct SpatialPolar {
+    float sinAz;         // sin(azimuth), > 0 → source on the left
+    float elevN;         // elevation / 90°, −1…+1
+    float dist;          // m
+    float height;        // m above the listener (floor reflection path)
+};
+
+// Engine axes: x left, y up, z front
+static inline SpatialPolar spatialPolar(float x, float y, float z)
+{
+    float horizDist = fastSqrt(x * x + z * z) + 1.0e-6f;      // avoid /0
+    float dist      = fastSqrt(x * x + y * y + z * z + 1.0e-6f);
+    return { clampf(x / horizDist, -1.0f, 1.0f),
+             fastAsin(clampf(y / dist, -1.0f, 1.0f)) * 0.63661977f,      // 2 / π
+             dist, y };
+}
+
+// Normalised biquad coefficients (a0 already divided out)
+struct BiquadCoeffs {
+    float b0, b1, b2, a1, a2;
+};
+
+// ────────────────────────────────────────────────────────────────
+// Biquad with coefficient smoothing
+// ────────────────────────────────────────────────────────────────
+class Biquad {
+public:
+    Biquad() { clear(); }
+
+    float process(float x) {
+        float y = b0 * x + z1;
+        z1 = b1 * x - a1 * y + z2;
+        z2 = b2 * x - a2 * y;
+        return y;
+    }
+
+    // Smoothed towards already-normalised coefficients
+    // (smooth = SpatialRate::coeffSmooth)
+    void setNormalized(const BiquadCoeffs& c, float smooth)
+    {
+        b0 = smooth * b0 + (1.0f - smooth) * c.b0;
+        b1 = smooth * b1 + (1.0f - smooth) * c.b1;
+        b2 = smooth * b2 + (1.0f - smooth) * c.b2;
+        a1 = smooth * a1 + (1.0f - smooth) * c.a1;
+        a2 = smooth * a2 + (1.0f - smooth) * c.a2;
+    }
+
+    void setCoeffs(float _b0, float _b1, float _b2,
+                   float _a0, float _a1, float _a2, float smooth)
+    {
+        setNormalized({ _b0 / _a0, _b1 / _a0, _b2 / _a0, _a1 / _a0, _a2 / _a0 }, smooth);
+    }
+
+    void clear() { b0 = 1; b1 = b2 = a1 = a2 = z1 = z2 = 0; }
+
+    // Jumps to c with empty state (a filter that has not been running)
+    void snap(const BiquadCoeffs& c)
+    {
+        b0 = c.b0; b1 = c.b1; b2 = c.b2; a1 = c.a1; a2 = c.a2;
+        z1 = z2 = 0;
+    }
+
+private:
+    float b0{}, b1{}, b2{}, a1{}, a2{}, z1{}, z2{};
+};
+
+// ────────────────────────────────────────────────────────────────
+// TPT state-variable filter
+// ────────────────────────────────────────────────────────────────
+// Trapezoidal (zero-delay feedback) SVF after Zavalishin / Simper, the
+// alternative topology for the head-shadow shelf and pinna notch.  Its
+// state is two integrator memories that stay valid under any change of
+// cutoff or gain, so the parameters can move every sample with no
+// coefficient smoothing and no risk to stability.  The output mixes the
+// input with the band and low outputs: y = m0·x + m1·band + m2·low.
+enum SpatialFilter : uint8_t {
+    kFilterBiquad,       // DF-II transposed, coefficients smoothed every 8 samples
+    kFilterSvf,          // TPT SVF, parameters ramped every sample
+    kNumSpatialFilters,
+};
+
+struct SvfParams {
+    float g;             // tan(π·fc / fs)
+    float k;             // 1 / Q
+    float m0, m1, m2;
+
+    // Per-sample increment that reaches `to` after n advance() calls
+    SvfParams stepTo(const SvfParams& to, int n) const
+    {
+        const float inv = 1.0f / n;
+        return { (to.g - g) * inv, 0.0f, (to.m0 - m0) * inv, (to.m1 - m1) * inv, (to.m2 - m2) * inv };
+    }
+
+    void advance(const SvfParams& step)
+    {
+        g  += step.g;
+        m0 += step.m0;
+        m1 += step.m1;
+        m2 += step.m2;
+    }
+};
+
+// Integrator gains for one (g, k); filters sharing a cutoff share them
+struct SvfGains {
+    float a1, a2, a3;
+};
+
+static inline SvfGains svfGains(const SvfParams& p)
+{
+    const float a1 = 1.0f / (1.0f + p.g * (p.g + p.k));
+    const float a2 = p.g * a1;
+    return { a1, a2, p.g * a2 };
+}
+
+class Svf {
+public:
+    float process(float x, const SvfParams& p, const SvfGains& a)
+    {
+        float v3 = x - ic2;
+        float v1 = a.a1 * ic1 + a.a2 * v3;          // band
+        float v2 = ic2 + a.a2 * ic1 + a.a3 * v3;    // low
+        ic1 = 2.0f * v1 - ic1;
+        ic2 = 2.0f * v2 - ic2;
+        return p.m0 * x + p.m1 * v1 + p.m2 * v2;
+    }
+
+    float process(float x, const SvfParams& p) { return process(x, p, svfGains(p)); }
+
+    void clear() { ic1 = ic2 = 0.0f; }
+
+private:
+    float ic1 = 0.0f, ic2 = 0.0f;
+};
+
+// ────────────────────────────────────────────────────────────────
+// Coefficient tables for the head-shadow shelf and pinna notch
+// ────────────────────────────────────────────────────────────────
+// The shelf only varies with sinAz and the notch only with elevN, both
+// in [-1, 1], so each is a 1-D grid of normalised coefficients with
+// linear interpolation between points.  The biquad stability region is
+// convex in (a1, a2), so interpolating two stable neighbours is stable.
+// More points → closer to the exact builders, at 40 bytes per point.
+class SpatialCoeffTable {
+public:
+    static constexpr int kMinPoints = 2;
+    static constexpr int kMaxPoints = 129;
+
+    static uint32_t storageBytes(int points) {
+        return 2u * static_cast<uint32_t>(points) * sizeof(BiquadCoeffs);
+    }
+
+    // Builds both grids into caller-provided storage (storageBytes())
+    // for one sample rate; call again with the same storage on a change.
+    void init(void* storage, int points, const SpatialRate& rate);
+
+    // Reads every stride-th point of a finer table, without storage of
+    // its own, when points − 1 divides full.size() − 1 (false
+    // otherwise).  The values are those init() would build, and follow
+    // full when it is rebuilt.
+    bool view(const SpatialCoeffTable& full, int points);
+    static bool viewable(int fullPoints, int points) {
+        points = clampPoints(points);
+        return (fullPoints - 1) % (points - 1) == 0;
+    }
+
+    // Shelf for the left ear at sinAz; the right ear is shelf(-sinAz).
+    void shelf(float sinAz, BiquadCoeffs& c) const { lookup(shelfGrid, sinAz, c); }
+    void notch(float elevN, BiquadCoeffs& c) const { lookup(notchGrid, elevN, c); }
+
+    int size() const { return numPoints; }
+
+private:
+    static int clampPoints(int points) {
+        return (points < kMinPoints) ? kMinPoints : (points > kMaxPoints) ? kMaxPoints : points;
+    }
+
+    void lookup(const BiquadCoeffs* grid, float x, BiquadCoeffs& c) const {
+        float pos = (clampf(x, -1.0f, 1.0f) + 1.0f) * halfSpan;
+        int   i   = static_cast<int>(pos);
+        if (i > numPoints - 2) i = numPoints - 2;
+        float f   = pos - static_cast<float>(i);
+        const BiquadCoeffs& p = grid[i * stride];
+        const BiquadCoeffs& q = grid[(i + 1) * stride];
+        c.b0 = p.b0 + f * (q.b0 - p.b0);
+        c.b1 = p.b1 + f * (q.b1 - p.b1);
+        c.b2 = p.b2 + f * (q.b2 - p.b2);
+        c.a1 = p.a1 + f * (q.a1 - p.a1);
+        c.a2 = p.a2 + f * (q.a2 - p.a2);
+    }
+
+    const BiquadCoeffs* shelfGrid = nullptr;
+    const BiquadCoeffs* notchGrid = nullptr;
+    int                 numPoints = 0;
+    int                 stride    = 1;         // grid entries per point
+    float               halfSpan  = 0.0f;      // (numPoints - 1) / 2
+};
+
+// ────────────────────────────────────────────────────────────────
+// One-pole low-pass (air absorption)
+// ────────────────────────────────────────────────────────────────
+class OnePoleLP {
+public:
+    OnePoleLP() : alpha(0.0f), y1(0.0f) {}
+
+    void setCutoff(float fc, const SpatialRate& rate) {
+        // T / (RC + T) with RC = 1 / (2π·fc): one float divide, as it
+        // runs on the control grid
+        fc = clampf(fc, 50.0f, rate.maxFilterFc);
+        float w = 6.2831853f * fc * rate.invSampleRate;
+        alpha = w / (1.0f + w);
+    }
+
+    // The other ear's cutoff, without recomputing it
+    void copyCutoff(const OnePoleLP& other) { alpha = other.alpha; }
+
+    float process(float x) {
+        y1 += alpha * (x - y1);
+        return y1;
+    }
+
+    void clear() { y1 = 0.0f; }
+
+private:
+    float alpha, y1;
+};
+
+// ────────────────────────────────────────────────────────────────
+// Delay sample storage
+// ────────────────────────────────────────────────────────────────
+// Input histories can be stored at reduced precision to halve their
+// memory (build with TINEAR_DELAY_FORMAT, make DELAY_FORMAT=…); filter
+// state stays float.  Samples are encoded on write and decoded by each
+// tap read, so the interpolators see plain floats.
+//   0  float32
+//   1  int16, ±kDelayInt16FullScale V, saturating: a fixed noise floor,
+//      ≈ 92 dB below a 10 V sine
+//   2  IEEE half, saturating at ±65504: ≈ 70 dB SNR at any level
+#ifndef TINEAR_DELAY_FORMAT
+#define TINEAR_DELAY_FORMAT 0
+#endif
+
+constexpr float kDelayInt16FullScale = 20.0f;       // V
+
+struct DelayCodecFloat {
+    using Stored = float;
+    static Stored encode(float x) { return x; }
+    static float  decode(Stored s) { return s; }
+};
+
+struct DelayCodecInt16 {
+    using Stored = int16_t;
+    static Stored encode(float x)
+    {
+        float v = clampf(x * (32767.0f / kDelayInt16FullScale), -32767.0f, 32767.0f);
+        return static_cast<int16_t>(v < 0.0f ? v - 0.5f : v + 0.5f);
+    }
+    static float decode(Stored s) { return s * (kDelayInt16FullScale / 32767.0f); }
+};
+
+// Round-to-nearest-even float ↔ half with subnormals, by integer
+// arithmetic unless the target converts in hardware
+struct DelayCodecHalf {
+    using Stored = uint16_t;
+#if defined(__ARM_FP16_FORMAT_IEEE)
+    static Stored encode(float x)
+    {
+        __fp16 h = clampf(x, -65504.0f, 65504.0f);
+        Stored s;
+        memcpy(&s, &h, sizeof(s));
+        return s;
+    }
+    static float decode(Stored s)
+    {
+        __fp16 h;
+        memcpy(&h, &s, sizeof(h));
+        return h;
+    }
+#else
+    static Stored encode(float x)
+    {
+        uint32_t u;
+        memcpy(&u, &x, sizeof(u));
+        const uint32_t sign = (u >> 16) & 0x8000u;
+        u &= 0x7fffffffu;
+
+        uint32_t h;
+        if (u >= 0x477ff000u) {                      // rounds to ≥ 65520, or NaN
+            h = 0x7bffu;
+        } else if (u < 0x38800000u) {                // below 2^−14: subnormal
+            // Adding 0.5 aligns the mantissa to the half subnormal step
+            float f;
+            memcpy(&f, &u, sizeof(f));
+            f += 0.5f;
+            memcpy(&u, &f, sizeof(u));
+            h = u - 0x3f000000u;
+        } else {
+            u += 0xc8000fffu + ((u >> 13) & 1u);     // rebias, round to even
+            h = u >> 13;
+        }
+        return static_cast<Stored>(h | sign);
+    }
+    static float decode(Stored s)
+    {
+        uint32_t u = (s & 0x7fffu) << 13;
+        if (u < 0x00800000u) {                       // subnormal or zero
+            // m·2^−24 via 2^−14 · (1.m − 1)
+            u += 0x38800000u;
+            float f;
+            memcpy(&f, &u, sizeof(f));
+            f -= 6.10351562e-05f;
+            memcpy(&u, &f, sizeof(u));
+        } else {
+            u += 0x38000000u;
+        }
+        u |= static_cast<uint32_t>(s & 0x8000u) << 16;
+        float f;
+        memcpy(&f, &u, sizeof(f));
+        return f;
+    }
+#endif
+};
+
+#if TINEAR_DELAY_FORMAT == 1
+using DelayCodec = DelayCodecInt16;
+#elif TINEAR_DELAY_FORMAT == 2
+using DelayCodec = DelayCodecHalf;
+#else
+using DelayCodec = DelayCodecFloat;
+#endif
+
+// ────────────────────────────────────────────────────────────────
+// Multi-tap fractional delay
+// ────────────────────────────────────────────────────────────────
+// One history of the emitter input, read by any number of fractional
+// taps (each ear, each reflection).  Every reader adds one sample of
+// bulk delay so the 4-point and allpass readers always have a sample
+// on either side; the ears stay aligned because all taps share it.
+// Taps that differ by whole samples can share one DelayPos (read's
+// offset); the floor reflections ramp their delay every sample, so each
+// takes a position of its own.
+enum DelayInterp : uint8_t {
+    kInterpLinear,       // 2 points
+    kInterpLagrange3,    // 4 points, 3rd-order Lagrange
+    kInterpThiran,       // 1st-order Thiran allpass, per-tap state
+    kNumDelayInterps,
+};
+
+// Per-tap reader state (only the Thiran allpass uses it)
+struct DelayTap {
+    float x1 = 0.0f, y1 = 0.0f;
+    void clear() { x1 = y1 = 0.0f; }
+};
+
+// Integer read index and fractional part (Thiran: allpass coefficient)
+struct DelayPos {
+    int   index;
+    float frac;
+};
+
+// Read position for a delay of up to maxDelay samples (plus the one
+// sample of bulk delay)
+template <DelayInterp kInterp>
+static inline DelayPos delayPosition(float delay, float maxDelay)
+{
+    float d = clampf(delay, 0.0f, maxDelay) + 1.0f;               // ≥ 1
+    int   i = static_cast<int>(d);
+    float f = d - static_cast<float>(i);
+    if (kInterp == kInterpThiran) {
+        // Integer part i with the allpass covering 0.5 … 1.5
+        if (f < 0.5f) { f += 1.0f; --i; }
+        f = (1.0f - f) / (1.0f + f);
+    }
+    return { i, f };
+}
+
+// Tap reader shared by DelayHistory and DelayBuffer: H provides at(n)
+// and maxIndex()
+template <DelayInterp kInterp, class H>
+static inline float delayRead(const H& h, DelayTap& tap, DelayPos p, int offset)
+{
+    int   i = p.index + offset;
+    float f = p.frac;
+    if (i > h.maxIndex())
+        i = h.maxIndex();
+
+    if (kInterp == kInterpLinear) {
+        float y0 = h.at(i);
+        return y0 + f * (h.at(i + 1) - y0);
+    }
+    if (kInterp == kInterpLagrange3) {
+        // Points i−1 … i+2; fractional position 1 + f within them
+        float h0 = -f * (f - 1.0f) * (f - 2.0f) * (1.0f / 6.0f);
+        float h1 = (f + 1.0f) * (f - 1.0f) * (f - 2.0f) * 0.5f;
+        float h2 = -(f + 1.0f) * f * (f - 2.0f) * 0.5f;
+        float h3 = (f + 1.0f) * f * (f - 1.0f) * (1.0f / 6.0f);
+        return h0 * h.at(i - 1) + h1 * h.at(i) + h2 * h.at(i + 1) + h3 * h.at(i + 2);
+    }
+    // Thiran: y = a·x + x[−1] − a·y[−1]
+    float xn = h.at(i);
+    float y  = f * (xn - tap.y1) + tap.x1;
+    tap.x1 = xn;
+    tap.y1 = y;
+    return y;
+}
+
+template <int kSize, class Codec = DelayCodec>
+class DelayHistory {
+public:
+    static_assert((kSize & (kSize - 1)) == 0, "history length must be a power of two");
+    static constexpr int   kMask     = kSize - 1;
+    static constexpr int   kMaxIndex = kSize - 3;                      // i + 2 stays in range
+    static constexpr float kMaxDelay = static_cast<float>(kSize - 4);  // taps clamp here
+
+    DelayHistory() { clear(); }
+    void clear() { memset(buf, 0, sizeof(buf)); head = 0; }
+
+    // Appends the newest sample (delay 0 for the taps that follow)
+    void write(float x)
+    {
+        head = (head + 1) & kMask;
+        buf[head] = Codec::encode(x);
+    }
+
+    // Sample written n calls ago
+    float at(int n) const { return Codec::decode(buf[(head - n) & kMask]); }
+    int   maxIndex() const { return kMaxIndex; }
+
+    template <DelayInterp kInterp>
+    static DelayPos position(float delay)
+    {
+        return delayPosition<kInterp>(delay, kMaxDelay);
+    }
+
+    // Tap at p, plus `offset` further whole samples
+    template <DelayInterp kInterp>
+    float read(DelayTap& tap, DelayPos p, int offset = 0) const
+    {
+        return delayRead<kInterp>(*this, tap, p, offset);
+    }
+
+    template <DelayInterp kInterp>
+    float read(DelayTap& tap, float delay) const
+    {
+        return read<kInterp>(tap, position<kInterp>(delay));
+    }
+
+    float read(DelayTap& tap, float delay, DelayInterp interp) const
+    {
+        switch (interp) {
+        case kInterpLagrange3: return read<kInterpLagrange3>(tap, delay);
+        case kInterpThiran:    return read<kInterpThiran>(tap, delay);
+        default:               return read<kInterpLinear>(tap, delay);
+        }
+    }
+
+private:
+    typename Codec::Stored buf[kSize];
+    int                    head;
+};
+
+// The same history in caller-provided storage of run-time power-of-two
+// length, for buffers too long for fast memory.  Taps beyond the length
+// clamp to the oldest sample.  Unbound (no storage) until bind().
+template <class Codec>
+class DelayBufferOf {
+public:
+    static constexpr uint32_t kSampleBytes = sizeof(typename Codec::Stored);
+
+    // Shortest length whose taps reach maxDelay samples
+    static int lengthFor(int maxDelay)
+    {
+        int n = 8;
+        while (n < maxDelay + 4)
+            n <<= 1;
+        return n;
+    }
+
+    // storage: length · kSampleBytes bytes
+    void bind(void* storage, int length)
+    {
+        buf  = static_cast<typename Codec::Stored*>(storage);
+        mask = length - 1;
+        clear();
+    }
+
+    bool bound() const { return buf != nullptr; }
+    int  length() const { return mask + 1; }
+    void clear()
+    {
+        if (buf)
+            memset(buf, 0, length() * kSampleBytes);
+        head = 0;
+    }
+
+    void write(float x)
+    {
+        head = (head + 1) & mask;
+        buf[head] = Codec::encode(x);
+    }
+
+    float at(int n) const { return Codec::decode(buf[(head - n) & mask]); }
+    int   maxIndex() const { return mask - 2; }
+
+    // Position of a tap delay samples back; delays past the buffer clamp
+    template <DelayInterp kInterp>
+    DelayPos position(float delay) const
+    {
+        return delayPosition<kInterp>(delay, static_cast<float>(mask - 3));
+    }
+
+    template <DelayInterp kInterp>
+    float read(DelayTap& tap, DelayPos p, int offset = 0) const
+    {
+        return delayRead<kInterp>(*this, tap, p, offset);
+    }
+
+private:
+    typename Codec::Stored* buf  = nullptr;
+    int                     mask = 0;
+    int                     head = 0;
+};
+
+using DelayBuffer = DelayBufferOf<DelayCodec>;
+
+// Emitter input histories.  The ITD history lives in the state (DTC)
+// and covers the 0.5 ms ITD up to kMaxSampleRate.  The floor reflection
+// reads a separate DelayBuffer (DRAM, bound by the owner) whose length
+// follows the furthest source: the reflection path adds at most the
+// source distance on top of the ITD.
+constexpr int kItdHistory = 64;
+static_assert(0.0005f * kMaxSampleRate + 4.0f <= kItdHistory, "ITD history too short");
+
+static inline int reflectionHistoryLength(float sampleRate, float maxDistance)
+{
+    return DelayBuffer::lengthFor(static_cast<int>(maxDistance * sampleRate / kSpeedOfSound +
+                                                   0.0005f * sampleRate) + 2);
+}
+
+// ────────────────────────────────────────────────────────────────
+// Level of detail
+// ────────────────────────────────────────────────────────────────
+// Cheaper renderings of the same chain for emitters a CPU budget can't
+// afford at full quality.  Tier changes crossfade over
+// SpatialRate::detailFade samples; the fade runs the richer tier and
+// blends in the cheaper tier's signal, which it computes on the way.
+enum SpatialDetail : uint8_t {
+    kDetailFull,         // shelf + notch coefficients every 8 samples
+    kDetailReduced,      // shelf coefficients once per block, no pinna notch
+    kDetailPan,          // ITD + ILD only: no reflection, air, shelf or notch
+    kNumSpatialDetails,
+};
+
+// Loop structure of the parametric kernel; the output is bit-identical
+enum SpatialKernel : uint8_t {
+    kKernelFused,        // control and audio work interleaved per sample
+    kKernelTwoPass,      // control pass per 8 samples into arrays, then the audio pass
+};
+
+// Stages of the parametric chain a patch can do without.  The kernel is
+// specialised for each set, so a stage left out is compiled out rather
+// than run at a neutral setting; the cheaper tiers drop theirs anyway.
+// The reflection history is still written, so the stage resumes cleanly.
+enum SpatialQuality : uint8_t {
+    kQualityFull,          // floor reflection + pinna notch
+    kQualityNoNotch,       // horizontal-only layouts
+    kQualityNoReflection,  // an external reverb supplies the room
+    kQualityDirect,        // neither
+    kNumSpatialQualities,
+};
+
+// One specialisation of the kernel (interpolation × filter × quality ×
+// store/accumulate), chosen by setSpatialKernel
+struct SpatialAudioState;
+typedef void (*SpatialRenderFn)(const float* in, float* outL, float* outR, int numSamples,
+                                const SpatialPolar& target, float gain, float gainStep,
+                                SpatialAudioState* state);
+
+// Points state's kernels at the specialisation for its interp, filter
+// and quality; call after changing any of them
+void setSpatialKernel(SpatialAudioState* state);
+
+// ────────────────────────────────────────────────────────────────
+// Per-emitter spatial audio state structure
+// ────────────────────────────────────────────────────────────────
+struct SpatialAudioState {
+    Biquad    notchL, notchR, shelfL, shelfR;
+    OnePoleLP airL, airR;
+
+    // Input histories (ITD; reflection, unbound → no floor reflection);
+    // taps for each ear's direct path and reflection
+    DelayHistory<kItdHistory> history;
+    DelayBuffer reflHistory;
+    DelayTap    tapL, tapR, reflTapL, reflTapR;
+    DelayInterp interp;
+
+    // Shelf / notch topology; the SVF parameters follow prevSinAz and
+    // prevElevN, so only the integrators are kept
+    SpatialFilter filter;
+    Svf           svfShelfL, svfShelfR, svfNotchL, svfNotchR;
+
+    SpatialKernel kernel;
+
+    // Stage set, and the kernels specialised for it (setSpatialKernel)
+    SpatialQuality  quality;
+    SpatialRenderFn renderStore;
+    SpatialRenderFn renderAccumulate;
+
+    // Current tier, and the one being faded from while fadeRemaining > 0
+    SpatialDetail detail;
+    SpatialDetail fadeFrom;
+    int           fadeRemaining;
+
+    float prevSinAz;      // smoothed sin(azimuth)
+    float prevElevN;      // smoothed elevation norm
+    float prevDist;
+    float prevReflDelay;  // floor-reflection delay, samples, signed (reflectionDelay)
+
+    // Samples since the last control-grid update (kControlInterval)
+    int controlPhase;
+
+    // Shelf/notch coefficients come from this table when set,
+    // otherwise from the exact builders (trig per update).
+    const SpatialCoeffTable* coeffTable;
+
+    // Rate-dependent constants, owned by the plugin instance
+    const SpatialRate* rate;
+
+#if TINEAR_PROFILE
+    // Stage timing for the kernel; nullptr outside the plugin
+    TinearProfile* profile = nullptr;
+#endif
+
+    SpatialAudioState()
+        : interp(kInterpLinear), filter(kFilterBiquad), kernel(kKernelTwoPass),
+          quality(kQualityFull), detail(kDetailFull), fadeFrom(kDetailFull), fadeRemaining(0),
+          prevSinAz(0.0f), prevElevN(0.0f), prevDist(1.0f), prevReflDelay(0.0f),
+          controlPhase(0), coeffTable(nullptr),
+          rate(&kDefaultSpatialRate) { setSpatialKernel(this); }
+};
+
+// ────────────────────────────────────────────────────────────────
+// Exact filter builders (normalised coefficients)
+// ────────────────────────────────────────────────────────────────
+void notchCoeffs(const SpatialRate& rate, float fc, float Q, BiquadCoeffs& c);
+void highShelfCoeffs(const SpatialRate& rate, float fc, float dBgain, BiquadCoeffs& c);
+
+// The same shelf (at kShelfFc) and notch (Q = kNotchQ) as SVF parameters
+void highShelfSvf(const SpatialRate& rate, float dBgain, SvfParams& p);
+void notchSvf(const SpatialRate& rate, float fc, SvfParams& p);
+
+// Starts a crossfade to `detail`; false (and no change) while the
+// previous fade is still running.  Filters the old tier left idle are
+// restarted from the current position with empty state.
+bool setSpatialDetail(SpatialAudioState* state, SpatialDetail detail);
+
+// Changes the stage set; a pinna notch coming back restarts from the
+// current position with empty state
+void setSpatialQuality(SpatialAudioState* state, SpatialQuality quality);
+
+// ────────────────────────────────────────────────────────────────
+// Public API (modified to accept per-emitter state)
+// ────────────────────────────────────────────────────────────────
+extern "C"
+void applyMonoSpatialAudio(const float* in,
+                           float* outL,
+                           float* outR,
+                           const int    numSamples,
+                           const float  srcX,
+                           const float  srcY,
+                           const float  srcZ,
+                           SpatialAudioState* state);
+
+// Fused variant: renders straight into the destination bus with a
+// linear gain ramp gainStart → gainEnd across the block.  overwrite
+// stores instead of adding (first emitter in Replace mode), so no
+// scratch buffers or separate clear/mix passes are needed.
+extern "C"
+void applyMonoSpatialAudioMix(const float* in,
+                              float* outL,
+                              float* outR,
+                              const int    numSamples,
+                              const float  srcX,
+                              const float  srcY,
+                              const float  srcZ,
+                              const float  gainStart,
+                              const float  gainEnd,
+                              const bool   overwrite,
+                              SpatialAudioState* state);
+
+// As applyMonoSpatialAudioMix, with the position already in the
+// kernel's polar form: no Cartesian round trip
+extern "C"
+void applyMonoSpatialAudioPolar(const float* in,
+                                float* outL,
+                                float* outR,
+                                const int    numSamples,
+                                const SpatialPolar* target,
+                                const float  gainStart,
+                                const float  gainEnd,
+                                const bool   overwrite,
+                                SpatialAudioState* state);
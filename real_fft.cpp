@@ -0,0 +1,114 @@
+// Real-input FFT for the convolution engines – see real_fft.h
+
+#include "real_fft.h"
+
+#include <cmath>
+
+void RealFft::init(int size)
+{
+    n     = size;
+    half  = size / 2;
+    log2h = 0;
+    while ((1 << log2h) < half)
+        ++log2h;
+
+    for (int k = 0; k < half / 2; ++k) {
+        double a = -2.0 * M_PI * k / half;
+        twRe[k]  = static_cast<float>(cos(a));
+        twIm[k]  = static_cast<float>(sin(a));
+    }
+    for (int k = 0; k <= half; ++k) {
+        double a   = -2.0 * M_PI * k / n;
+        splitRe[k] = static_cast<float>(cos(a));
+        splitIm[k] = static_cast<float>(sin(a));
+    }
+    for (int i = 0; i < half; ++i) {
+        int r = 0;
+        for (int b = 0; b < log2h; ++b)
+            r |= ((i >> b) & 1) << (log2h - 1 - b);
+        bitrev[i] = static_cast<uint16_t>(r);
+    }
+}
+
+// In-place iterative radix-2 DIT on split arrays of length half.
+// The inverse is unscaled.
+void RealFft::complexFft(float* re, float* im, bool inverse)
+{
+    for (int i = 0; i < half; ++i) {
+        int j = bitrev[i];
+        if (j > i) {
+            float t = re[i]; re[i] = re[j]; re[j] = t;
+            t       = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    const float sign = inverse ? -1.0f : 1.0f;
+
+    // First stage has only trivial twiddles
+    for (int i = 0; i < half; i += 2) {
+        float ar = re[i], ai = im[i], br = re[i + 1], bi = im[i + 1];
+        re[i]     = ar + br; im[i]     = ai + bi;
+        re[i + 1] = ar - br; im[i + 1] = ai - bi;
+    }
+
+    for (int len = 4; len <= half; len <<= 1) {
+        const int hl     = len >> 1;
+        const int stride = half / len;
+        for (int i = 0; i < half; i += len) {
+            for (int j = 0; j < hl; ++j) {
+                const float wr = twRe[j * stride];
+                const float wi = sign * twIm[j * stride];
+                const int   a  = i + j;
+                const int   b  = a + hl;
+                float tr = re[b] * wr - im[b] * wi;
+                float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr; im[b] = im[a] - ti;
+                re[a] += tr;        im[a] += ti;
+            }
+        }
+    }
+}
+
+void RealFft::forward(const float* in, float* re, float* im)
+{
+    for (int k = 0; k < half; ++k) {
+        workRe[k] = in[2 * k];
+        workIm[k] = in[2 * k + 1];
+    }
+    complexFft(workRe, workIm, false);
+
+    // Split the packed even/odd transform: X[k] = E[k] + W^k·O[k]
+    for (int k = 0; k <= half; ++k) {
+        const int   a   = (k == half) ? 0 : k;
+        const int   b   = (k == 0) ? 0 : half - k;
+        const float zr  = workRe[a],  zi  = workIm[a];
+        const float cr  = workRe[b],  ci  = -workIm[b];     // conj(Z[half-k])
+        const float er  = 0.5f * (zr + cr), ei = 0.5f * (zi + ci);
+        const float or_ = 0.5f * (zi - ci), oi = -0.5f * (zr - cr);
+        re[k] = er + splitRe[k] * or_ - splitIm[k] * oi;
+        im[k] = ei + splitRe[k] * oi  + splitIm[k] * or_;
+    }
+}
+
+void RealFft::inverse(const float* re, const float* im, float* out)
+{
+    // Merge: E[k] = (X[k] + conj X[half-k]) / 2
+    //        O[k] = (X[k] − conj X[half-k]) / 2 · conj(W^k),  Z = E + i·O
+    for (int k = 0; k < half; ++k) {
+        const float xr  = re[k],        xi = im[k];
+        const float cr  = re[half - k], ci = -im[half - k];
+        const float er  = 0.5f * (xr + cr), ei = 0.5f * (xi + ci);
+        const float dr  = 0.5f * (xr - cr), di = 0.5f * (xi - ci);
+        const float or_ = dr * splitRe[k] + di * splitIm[k];
+        const float oi  = di * splitRe[k] - dr * splitIm[k];
+        workRe[k] = er - oi;
+        workIm[k] = ei + or_;
+    }
+    complexFft(workRe, workIm, true);
+
+    const float scale = 1.0f / half;
+    for (int k = 0; k < half; ++k) {
+        out[2 * k]     = workRe[k] * scale;
+        out[2 * k + 1] = workIm[k] * scale;
+    }
+}
@@ -0,0 +1,47 @@
+// Real-input FFT for the convolution engines
+// -------------------------------------------------------------------
+// • N-point real transform computed as an N/2-point complex radix-2 FFT
+//   plus a split/merge pass.  Spectra are held split-complex (separate
+//   re/im arrays of N/2+1 bins), which keeps the per-bin multiply-adds
+//   of partitioned convolution in plain, vectorisable float loops.
+// • All twiddles and the bit-reversal permutation are tabulated by
+//   init(); forward()/inverse() do no trig and no allocation.
+// • The object carries its own scratch, so one instance must not be
+//   used from two threads at once.
+
+#pragma once
+
+#include <cstdint>
+
+class RealFft {
+public:
+    static constexpr int kMaxSize = 512;
+
+    // size must be a power of two in [8, kMaxSize]
+    void init(int size);
+
+    int size() const { return n; }
+    int bins() const { return n / 2 + 1; }
+
+    // in: size() reals → re/im: bins() values each
+    void forward(const float* in, float* re, float* im);
+
+    // re/im: bins() values → out: size() reals; inverse(forward(x)) == x
+    void inverse(const float* re, const float* im, float* out);
+
+private:
+    void complexFft(float* re, float* im, bool inverse);
+
+    int n     = 0;      // real length
+    int half  = 0;      // complex length n/2
+    int log2h = 0;
+
+    float    twRe[kMaxSize / 4];          // e^{-2πik/half}, k < half/2
+    float    twIm[kMaxSize / 4];
+    float    splitRe[kMaxSize / 2 + 1];   // e^{-2πik/n},   k ≤ half
+    float    splitIm[kMaxSize / 2 + 1];
+    uint16_t bitrev[kMaxSize / 2];
+
+    float    workRe[kMaxSize / 2];
+    float    workIm[kMaxSize / 2];
+};
@@ -0,0 +1,141 @@
+// Shared late reverb – see reverb.h
+
+#include "reverb.h"
+
+// Line lengths: mutually prime-ish, spread over 31–74 ms so the modal
+// density is high from the first echoes on
+static const float kLineMs[kReverbLines] = {
+    31.3f, 37.9f, 41.1f, 47.3f, 53.7f, 59.9f, 67.1f, 73.7f,
+};
+
+// Hadamard rows for the within-half stage, the stereo output taps and
+// the send injection (per half: lines 0–3, 4–7)
+static const SpatialLaneVec kH4[4] = {
+    { 1.0f,  1.0f,  1.0f,  1.0f },
+    { 1.0f, -1.0f,  1.0f, -1.0f },
+    { 1.0f,  1.0f, -1.0f, -1.0f },
+    { 1.0f, -1.0f, -1.0f,  1.0f },
+};
+static const SpatialLaneVec kOutL[2] = { { 1.0f, -1.0f, 1.0f, -1.0f }, { 1.0f, -1.0f,  1.0f, -1.0f } };
+static const SpatialLaneVec kOutR[2] = { { 1.0f,  1.0f, -1.0f, -1.0f }, { 1.0f,  1.0f, -1.0f, -1.0f } };
+static const SpatialLaneVec kIn[2]   = { { 0.35f, -0.35f, 0.35f, 0.35f }, { -0.35f, 0.35f, 0.35f, -0.35f } };
+
+static uint32_t lineSamples(int line, float sampleRate)
+{
+    return static_cast<uint32_t>(kLineMs[line] * 0.001f * sampleRate + 0.5f);
+}
+
+uint32_t FdnReverb::storageFloats(float sampleRate)
+{
+    uint32_t total = 0;
+    for (int i = 0; i < kReverbLines; ++i)
+        total += lineSamples(i, sampleRate);
+    return total;
+}
+
+void FdnReverb::init(float* storage, float fs)
+{
+    lines = storage;
+    uint32_t at = 0;
+    for (int i = 0; i < kReverbLines; ++i) {
+        offset[i]   = at;
+        capacity[i] = lineSamples(i, fs);
+        at += capacity[i];
+    }
+    SpatialRate rate;
+    rate.set(fs);
+    setRate(rate);
+    clear();
+}
+
+void FdnReverb::setRate(const SpatialRate& rate)
+{
+    sampleRate = rate.sampleRate;
+    for (int i = 0; i < kReverbLines; ++i) {
+        uint32_t n = lineSamples(i, sampleRate);
+        length[i] = (n < capacity[i]) ? n : capacity[i];
+        if (pos[i] >= length[i])
+            pos[i] = 0;
+    }
+    setDecay(rt60, damping);
+}
+
+void FdnReverb::setDecay(float rt60_, float damping_)
+{
+    rt60    = rt60_;
+    damping = damping_;
+
+    // −60 dB after rt60 seconds: each pass through a line of n samples
+    // loses 60·n / (rt60·fs) dB
+    for (int i = 0; i < kReverbLines; ++i)
+        loopGain[i / 4][i % 4] = fastPow10(-3.0f * length[i] / (rt60 * sampleRate));
+
+    // Loop low-pass from 16 kHz (no damping) down to 1 kHz;
+    // α = 1 − e^(−2π·fc/fs) = 1 − 2^(−2π·log2(e)·fc/fs)
+    float fc = 16000.0f * fastExp2(-4.0f * damping);
+    fc = clampf(fc, 20.0f, 0.45f * sampleRate);
+    dampAlpha = laneSplat(1.0f - fastExp2(-9.0647202f * fc / sampleRate));
+}
+
+void FdnReverb::clear()
+{
+    if (lines) {
+        uint32_t total = 0;
+        for (int i = 0; i < kReverbLines; ++i)
+            total += capacity[i];
+        memset(lines, 0, total * sizeof(float));
+    }
+    for (int i = 0; i < kReverbLines; ++i)
+        pos[i] = 0;
+    dampState[0] = dampState[1] = SpatialLaneVec{};
+}
+
+void FdnReverb::process(const float* send, float* outL, float* outR, int numSamples,
+                        float gainStart, float gainEnd)
+{
+    const float          gainStep = (gainEnd - gainStart) / numSamples;
+    const float          norm     = 0.35355339f;          // 1 / √8
+    const SpatialLaneVec g0 = loopGain[0] * norm, g1 = loopGain[1] * norm;   // per line
+    float                gain = gainStart;
+    SpatialLaneVec       lp0 = dampState[0], lp1 = dampState[1];
+
+    for (int n = 0; n < numSamples; ++n) {
+        // Line outputs, damped
+        SpatialLaneVec a, b;
+        for (int i = 0; i < 4; ++i) {
+            a[i] = lines[offset[i] + pos[i]];
+            b[i] = lines[offset[i + 4] + pos[i + 4]];
+        }
+        lp0 += dampAlpha * (a - lp0);
+        lp1 += dampAlpha * (b - lp1);
+
+        // Stereo taps: two orthogonal sign patterns over all eight lines
+        SpatialLaneVec l = lp0 * kOutL[0] + lp1 * kOutL[1];
+        SpatialLaneVec r = lp0 * kOutR[0] + lp1 * kOutR[1];
+        gain += gainStep;
+        outL[n] += (l[0] + l[1] + l[2] + l[3]) * gain;
+        outR[n] += (r[0] + r[1] + r[2] + r[3]) * gain;
+
+        // Hadamard feedback on the gain-scaled lines: butterfly across
+        // the halves, then H4 within each as sign-row multiply-adds
+        SpatialLaneVec xa = lp0 * g0, xb = lp1 * g1;
+        SpatialLaneVec u = xa + xb;
+        SpatialLaneVec v = xa - xb;
+        SpatialLaneVec fa = kH4[0] * u[0] + kH4[1] * u[1] + kH4[2] * u[2] + kH4[3] * u[3];
+        SpatialLaneVec fb = kH4[0] * v[0] + kH4[1] * v[1] + kH4[2] * v[2] + kH4[3] * v[3];
+        fa += kIn[0] * send[n];
+        fb += kIn[1] * send[n];
+
+        for (int i = 0; i < 4; ++i) {
+            lines[offset[i] + pos[i]]         = fa[i];
+            lines[offset[i + 4] + pos[i + 4]] = fb[i];
+        }
+        for (int i = 0; i < kReverbLines; ++i) {
+            if (++pos[i] == length[i])
+                pos[i] = 0;
+        }
+    }
+
+    dampState[0] = lp0;
+    dampState[1] = lp1;
+}
@@ -0,0 +1,62 @@
+// Shared late reverb
+// -------------------------------------------------------------------
+// • One 8-line feedback delay network per plugin instance, fed by a
+//   mono send bus that every emitter adds into with a distance-dependent
+//   gain.  Its cost is fixed per block, whatever the emitter count.
+// • The feedback matrix is an 8×8 Hadamard (orthogonal, so the loop
+//   gain is set by the per-line gains alone), applied as one butterfly
+//   across two SpatialLaneVec halves and sign-pattern multiply-adds
+//   within them.
+// • Per-line gains give the same RT60 on every line; a one-pole
+//   low-pass in each loop shortens the high-frequency decay (Damping).
+// • Delay lines live in caller storage (DRAM), sized for one sample
+//   rate; a later, higher rate clamps them to what was allocated.
+
+#pragma once
+
+#include "spatial_lanes.h"
+
+constexpr int kReverbLines = 8;
+
+// Distance at which an emitter sends at half its gain: nearer sources
+// stay mostly dry, distant ones approach a full send
+constexpr float kReverbCriticalDistance = 1.5f;     // m
+
+static inline float reverbSendGain(float gain, float distance)
+{
+    return gain * distance / (distance + kReverbCriticalDistance);
+}
+
+struct FdnReverb {
+    // Delay-line storage for sampleRate, in floats
+    static uint32_t storageFloats(float sampleRate);
+
+    // Binds storage (storageFloats(sampleRate)), sets the line lengths
+    // for sampleRate and clears the network
+    void init(float* storage, float sampleRate);
+
+    // Line lengths (clamped to the storage) and loop gains for a new rate,
+    // RT60 in seconds or damping in 0…1
+    void setRate(const SpatialRate& rate);
+    void setDecay(float rt60, float damping);
+    void clear();
+
+    // Adds the stereo reverb of send[0…numSamples) into outL/outR, with
+    // the wet gain ramping linearly from gainStart to gainEnd
+    void process(const float* send, float* outL, float* outR, int numSamples,
+                 float gainStart, float gainEnd);
+
+    float*   lines = nullptr;
+    uint32_t capacity[kReverbLines] = {};   // allocated length per line
+    uint32_t length[kReverbLines]   = {};   // in use at the current rate
+    uint32_t offset[kReverbLines]   = {};   // start of each line in lines
+    uint32_t pos[kReverbLines]      = {};
+
+    float sampleRate = kSampleRate;
+    float rt60       = 1.5f;
+    float damping    = 0.5f;
+
+    SpatialLaneVec loopGain[2] = {};      // per line, lines 0–3 and 4–7
+    SpatialLaneVec dampAlpha   = {};      // one-pole coefficient, all lines
+    SpatialLaneVec dampState[2] = {};
+};
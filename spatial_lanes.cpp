@@ -0,0 +1,198 @@
+// Lane-parallel multi-emitter spatial audio engine – see spatial_lanes.h
+// -------------------------------------------------------------------
+// • Same signal chain and voicing as applyMonoSpatialAudio; only the
+//   data layout and loop order differ.
+// • Per sample, the delay taps are the only per-lane scalar work; the
+//   ramps, air absorption, ILD and all four biquads run as vectors.
+// • The bank's filters are shared, so lane 0's control phase stands for
+//   every lane and is written back to all of them.
+
+#include "spatial_lanes.h"
+
+template <DelayInterp kInterp>
+static void renderLanes(const float* const in[kSpatialLanes],
+                        float* outL,
+                        float* outR,
+                        int    numSamples,
+                        int    numLanes,
+                        const float srcX[kSpatialLanes],
+                        const float srcY[kSpatialLanes],
+                        const float srcZ[kSpatialLanes],
+                        const float gainStart[kSpatialLanes],
+                        const float gainEnd[kSpatialLanes],
+                        bool   overwrite,
+                        SpatialAudioState* const states[kSpatialLanes],
+                        SpatialLaneBank* bank)
+{
+    // ── 1. Per-lane block targets (as in applyMonoSpatialAudio) ───
+    SpatialLaneVec sinAz{}, elevN{}, dist{}, reflDelay{};
+    SpatialLaneVec sinAzStep{}, elevStep{}, distStep{}, reflStep{};
+    SpatialLaneVec g{}, gStep{};
+
+    const SpatialRate& rate = *states[0]->rate;
+    const float invN = 1.0f / numSamples;
+    for (int l = 0; l < numLanes; ++l) {
+        const SpatialAudioState* st = states[l];
+        const SpatialPolar target = spatialPolar(srcX[l], srcY[l], srcZ[l]);
+        const float sinAzT = target.sinAz;
+        const float elevNT = target.elevN;
+        const float distT  = target.dist;
+
+        sinAz[l]     = st->prevSinAz;
+        elevN[l]     = st->prevElevN;
+        dist[l]      = st->prevDist;
+        reflDelay[l] = st->prevReflDelay;
+        sinAzStep[l] = (sinAzT - st->prevSinAz) * invN;
+        elevStep[l]  = (elevNT - st->prevElevN) * invN;
+        distStep[l]  = (distT  - st->prevDist ) * invN;
+        reflStep[l]  = (reflectionDelay(target.height, rate) - st->prevReflDelay) * invN;
+        g[l]         = gainStart[l];
+        gStep[l]     = (gainEnd[l] - gainStart[l]) * invN;
+    }
+
+    const SpatialCoeffTable* table     = states[0]->coeffTable;
+    const SpatialLaneVec     reflScale = laneSplat(0.501187f);      // −6 dB
+    const SpatialLaneVec     ildDepth  = laneSplat(0.25f);
+    const SpatialLaneVec     one       = laneSplat(1.0f);
+
+    // ── 2. Process audio in lock-step ──────────────────────────────
+    int phase = states[0]->controlPhase;
+    for (int n = 0; n < numSamples; ++n) {
+        sinAz += sinAzStep;
+        elevN += elevStep;
+        dist  += distStep;
+        reflDelay += reflStep;
+        const bool control = phase == 0;
+        phase = (phase + 1) & (kControlInterval - 1);
+
+        // Direct + reflection taps per ear (per-lane histories);
+        // source on the left (sinAz > 0) → right ear lags
+        SpatialLaneVec left{}, right{}, reflL{}, reflR{};
+        for (int l = 0; l < numLanes; ++l) {
+            SpatialAudioState* st = states[l];
+            float s    = sinAz[l];
+            float itdL = rate.itdSamples * (s < 0.0f ? -s : 0.0f);
+            float itdR = rate.itdSamples * (s > 0.0f ?  s : 0.0f);
+            auto&    hist = st->history;
+            auto&    refl = st->reflHistory;
+            DelayPos posL = hist.template position<kInterp>(itdL);
+            DelayPos posR = hist.template position<kInterp>(itdR);
+            hist.write(in[l][n]);
+            left[l]  = hist.template read<kInterp>(st->tapL, posL);
+            right[l] = hist.template read<kInterp>(st->tapR, posR);
+            if (refl.bound()) {
+                refl.write(in[l][n]);
+                reflL[l] = refl.template read<kInterp>(st->reflTapL,
+                                                       refl.template position<kInterp>(itdL + fabsf(reflDelay[l])));
+                reflR[l] = refl.template read<kInterp>(st->reflTapR,
+                                                       refl.template position<kInterp>(itdR + fabsf(reflDelay[l])));
+            }
+        }
+
+        // Air absorption, cutoff on the control grid
+        if (control) {
+            for (int l = 0; l < numLanes; ++l) {
+                float w = 6.2831853f * airCutoff(dist[l]) * rate.invSampleRate;
+                bank->airAlpha[l] = w / (1.0f + w);
+            }
+        }
+        bank->airL += bank->airAlpha * (left  + reflL * reflScale - bank->airL);
+        bank->airR += bank->airAlpha * (right + reflR * reflScale - bank->airR);
+        left  = bank->airL;
+        right = bank->airR;
+
+        // ILD (broadband ±3 dB)
+        left  *= one + ildDepth * sinAz;
+        right *= one - ildDepth * sinAz;
+
+        // Update filter coefficients on the control grid
+        if (control) {
+            BiquadCoeffs sl[kSpatialLanes], sr[kSpatialLanes], nt[kSpatialLanes];
+            for (int l = 0; l < kSpatialLanes; ++l) {
+                // Idle lanes copy lane 0 so their filters stay benign.
+                int   src = (l < numLanes) ? l : 0;
+                float s   = sinAz[src];
+                float e   = elevN[src];
+                if (table) {
+                    table->shelf( s, sl[l]);
+                    table->shelf(-s, sr[l]);
+                    table->notch( e, nt[l]);
+                } else {
+                    highShelfCoeffs(rate, kShelfFc,  kShelfMaxDb * s, sl[l]);
+                    highShelfCoeffs(rate, kShelfFc, -kShelfMaxDb * s, sr[l]);
+                    notchCoeffs(rate, kNotchFc + kNotchSpan * e, kNotchQ, nt[l]);
+                }
+            }
+            bank->shelfL.setNormalized(sl, rate.coeffSmooth);
+            bank->shelfR.setNormalized(sr, rate.coeffSmooth);
+            bank->notchL.setNormalized(nt, rate.coeffSmooth);
+            bank->notchR.setNormalized(nt, rate.coeffSmooth);
+        }
+
+        // Head-shadow shelf + pinna notch
+        left  = bank->notchL.process(bank->shelfL.process(left));
+        right = bank->notchR.process(bank->shelfR.process(right));
+
+        // Gain ramp and mix across lanes
+        g     += gStep;
+        left  *= g;
+        right *= g;
+        float mixL = 0.0f, mixR = 0.0f;
+        for (int l = 0; l < kSpatialLanes; ++l) {
+            mixL += left[l];
+            mixR += right[l];
+        }
+        if (overwrite) {
+            outL[n] = mixL;
+            outR[n] = mixR;
+        } else {
+            outL[n] += mixL;
+            outR[n] += mixR;
+        }
+    }
+
+    // ── 3. Save smoothed state for next call ────────────────────────
+    for (int l = 0; l < numLanes; ++l) {
+        states[l]->prevSinAz = sinAz[l];
+        states[l]->prevElevN = elevN[l];
+        states[l]->prevDist  = dist[l];
+        states[l]->prevReflDelay = reflDelay[l];
+        states[l]->controlPhase  = phase;
+    }
+}
+
+void applyMonoSpatialAudioLanes(const float* const in[kSpatialLanes],
+                                float* outL,
+                                float* outR,
+                                int    numSamples,
+                                int    numLanes,
+                                const float srcX[kSpatialLanes],
+                                const float srcY[kSpatialLanes],
+                                const float srcZ[kSpatialLanes],
+                                const float gainStart[kSpatialLanes],
+                                const float gainEnd[kSpatialLanes],
+                                bool   overwrite,
+                                SpatialAudioState* const states[kSpatialLanes],
+                                SpatialLaneBank* bank)
+{
+    if (numLanes <= 0 || numSamples <= 0)
+        return;
+    if (numLanes > kSpatialLanes)
+        numLanes = kSpatialLanes;
+
+    // All lanes of an instance share one interpolation mode
+    switch (states[0]->interp) {
+    case kInterpLagrange3:
+        renderLanes<kInterpLagrange3>(in, outL, outR, numSamples, numLanes, srcX, srcY, srcZ,
+                                      gainStart, gainEnd, overwrite, states, bank);
+        break;
+    case kInterpThiran:
+        renderLanes<kInterpThiran>(in, outL, outR, numSamples, numLanes, srcX, srcY, srcZ,
+                                   gainStart, gainEnd, overwrite, states, bank);
+        break;
+    default:
+        renderLanes<kInterpLinear>(in, outL, outR, numSamples, numLanes, srcX, srcY, srcZ,
+                                   gainStart, gainEnd, overwrite, states, bank);
+        break;
+    }
+}
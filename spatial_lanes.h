@@ -0,0 +1,92 @@
+// Lane-parallel multi-emitter spatial audio engine
+// -------------------------------------------------------------------
+// • Runs kSpatialLanes emitters in lock-step.  Their filter state lives
+//   in a structure-of-arrays bank, so every biquad / one-pole recurrence
+//   is one vector operation across emitters.
+// • SpatialLaneVec is a GCC vector type: SSE or NEON on host builds,
+//   lowered to unrolled FPv5 scalar code on the Cortex-M7.
+// • Delay histories and ramp state stay in each emitter's SpatialAudioState,
+//   so the per-emitter and lane engines can be switched at runtime.
+
+#pragma once
+
+#include "professional_spatial_audio.h"
+
+constexpr int kSpatialLanes = 4;
+
+typedef float SpatialLaneVec __attribute__((vector_size(kSpatialLanes * sizeof(float))));
+
+static inline SpatialLaneVec laneSplat(float x)
+{
+    return SpatialLaneVec{} + x;
+}
+
+// ────────────────────────────────────────────────────────────────
+// kSpatialLanes biquads (DF-II transposed) with coefficient smoothing
+// ────────────────────────────────────────────────────────────────
+struct BiquadLanes {
+    SpatialLaneVec b0, b1, b2, a1, a2, z1, z2;
+
+    void clear() {
+        b0 = laneSplat(1.0f);
+        b1 = b2 = a1 = a2 = z1 = z2 = SpatialLaneVec{};
+    }
+
+    SpatialLaneVec process(SpatialLaneVec x) {
+        SpatialLaneVec y = b0 * x + z1;
+        z1 = b1 * x - a1 * y + z2;
+        z2 = b2 * x - a2 * y;
+        return y;
+    }
+
+    // Same smoothing as Biquad::setNormalized, one lane per emitter
+    void setNormalized(const BiquadCoeffs (&c)[kSpatialLanes], float smooth) {
+        SpatialLaneVec t0, t1, t2, t3, t4;
+        for (int l = 0; l < kSpatialLanes; ++l) {
+            t0[l] = c[l].b0; t1[l] = c[l].b1; t2[l] = c[l].b2;
+            t3[l] = c[l].a1; t4[l] = c[l].a2;
+        }
+        b0 = smooth * b0 + (1.0f - smooth) * t0;
+        b1 = smooth * b1 + (1.0f - smooth) * t1;
+        b2 = smooth * b2 + (1.0f - smooth) * t2;
+        a1 = smooth * a1 + (1.0f - smooth) * t3;
+        a2 = smooth * a2 + (1.0f - smooth) * t4;
+    }
+};
+
+// ────────────────────────────────────────────────────────────────
+// Structure-of-arrays filter state for one group of emitters
+// ────────────────────────────────────────────────────────────────
+struct SpatialLaneBank {
+    BiquadLanes    shelfL, shelfR, notchL, notchR;
+    SpatialLaneVec airAlpha;
+    SpatialLaneVec airL, airR;
+
+    SpatialLaneBank() { clear(); }
+
+    void clear() {
+        shelfL.clear(); shelfR.clear(); notchL.clear(); notchR.clear();
+        airAlpha = airL = airR = SpatialLaneVec{};
+    }
+};
+
+// ────────────────────────────────────────────────────────────────
+// Public API
+// ────────────────────────────────────────────────────────────────
+// Renders numLanes (1…kSpatialLanes) emitters and adds their mix, with
+// a per-lane linear gain ramp gainStart → gainEnd, into outL/outR (or
+// stores it when overwrite is set).  Unused lanes are ignored;
+// states[l] / in[l] only need to be valid for l < numLanes.
+void applyMonoSpatialAudioLanes(const float* const in[kSpatialLanes],
+                                float* outL,
+                                float* outR,
+                                int    numSamples,
+                                int    numLanes,
+                                const float srcX[kSpatialLanes],
+                                const float srcY[kSpatialLanes],
+                                const float srcZ[kSpatialLanes],
+                                const float gainStart[kSpatialLanes],
+                                const float gainEnd[kSpatialLanes],
+                                bool   overwrite,
+                                SpatialAudioState* const states[kSpatialLanes],
+                                SpatialLaneBank* bank);
@@ -3,68 +3,71 @@
 #include <new>
 #include <cstring>  // for memcpy
 
-// Include spatial audio definitions
-#include <cstring>  // for memset
-
-// Forward declarations for spatial audio classes
-class Biquad {
-public:
-    Biquad() { clear(); }
-    float process(float x);
-    void setCoeffs(float _b0, float _b1, float _b2, float _a0, float _a1, float _a2);
-    void clear() { b0 = 1; b1 = b2 = a1 = a2 = z1 = z2 = 0; }
-private:
-    float b0{}, b1{}, b2{}, a1{}, a2{}, z1{}, z2{};
-};
+// Spatial audio engine (Biquad, DelayHistory, SpatialAudioState, applyMonoSpatialAudio)
+#include "professional_spatial_audio.h"
+#include "spatial_lanes.h"
+#include "hrir_renderer.h"
+#include "hrtf_models.h"
+#include "ambisonic.h"
+#include "reverb.h"
+#include "vbap.h"
 
-class OnePoleLP {
-public:
-    OnePoleLP() : alpha(0.0f), y1(0.0f) {}
-    void setCutoff(float fc);
-    float process(float x);
-private:
-    float alpha, y1;
-};
+// Maximum number of emitters supported.  Beyond about 8 the Ambisonic
+// render mode is the practical choice: its per-emitter cost is the bus
+// encode only.
+constexpr int kMaxEmitters = 32;
 
-class DelayLine {
-public:
-    DelayLine() : writeIdx(0) { memset(buf, 0, sizeof(buf)); }
-    float process(float x, float delaySamples);
-private:
-    static constexpr int kMax = 512;
-    static constexpr int kMask = kMax - 1;
-    float buf[kMax]{};
-    int writeIdx;
-};
+// Control glides: position and output gain follow their parameters as
+// one-pole smoothers with a single time constant, solved exactly at each
+// block end so the motion is the same at any block size.  Position also
+// has a speed ceiling (the pace of the earlier slew limiter), which keeps
+// the per-block reflection tap and filter updates small on long moves.
+// A glide within kGlideSnap of its target lands on it.
+constexpr float kGlideTime = 0.05f;          // s
+constexpr float kGlideSpeed = 2.0f;          // rad/s, m/s
+constexpr float kGlideKnee = kGlideSpeed * kGlideTime;  // exponential below this distance
+constexpr float kGlideSnap = 1.0e-5f;        // rad, m, linear gain
 
-// Per-emitter spatial audio state structure
-struct SpatialAudioState {
-    Biquad    notchL, notchR, shelfL, shelfR;
-    OnePoleLP airLP;
-    DelayLine delayL, delayR;
-    DelayLine reflDelay;
-    
-    float prevSinAz;      // smoothed sin(azimuth)
-    float prevElevN;      // smoothed elevation norm
-    float prevDist;
-    
-    SpatialAudioState() : prevSinAz(0.0f), prevElevN(0.0f), prevDist(1.0f) {}
-};
+// Activity detection: input peak below this counts as silence (−100 dB
+// re 10 V), as does a gain at the bottom of the Gain range
+constexpr float kSilenceThreshold = 1.0e-4f;
+constexpr float kMuteFloorDb = -60.0f;
 
-// Professional spatial audio function declaration
-extern "C" {
-void applyMonoSpatialAudio(const float *input, float *outputL, float *outputR,
-                           int numSamples, float sourceX, float sourceY,
-                           float sourceZ, SpatialAudioState* state);
-}
+// Level of detail: cost of each tier in eighths of a full-quality
+// emitter (per-emitter engine, tinear_bench step / step-lod), release
+// of the audibility envelope, and the ranking bonus per tier held so
+// emitters of similar loudness don't trade tiers every block
+constexpr int kDetailCost[kNumSpatialDetails] = { 8, 5, 2 };
+constexpr float kDetailRelease = 0.3f;      // s
+constexpr float kDetailHold = 1.41f;        // +3 dB
 
-// Add missing constants
-#ifndef M_PI
-#define M_PI 3.14159265358979323846f
-#endif
+// CV inputs: the first CV inputs emitters get Azimuth / Elevation /
+// Distance CV busses (at most kMaxCvEmitters, which keeps every
+// parameter index within a page's 8 bits).  ±5 V sweeps the full
+// Azimuth and Elevation ranges and 10 V the Distance range; CV beyond
+// ±10 V is clipped.
+constexpr int kMaxCvEmitters = 16;
+constexpr float kCvAzimuthPerVolt = 0.62831853f;     // 36° in rad
+constexpr float kCvElevationPerVolt = 0.31415927f;   // 18° in rad
+constexpr float kCvMaxVolts = 10.0f;
+
+// Head tracking over MIDI: 14-bit yaw / pitch / roll on CC 16–18 (MSB)
+// and 48–50 (LSB), centre 8192, full scale ±180° (pitch ±90°), added to
+// the Listener page's parameters
+constexpr uint8_t kHeadMidiCcMsb = 16;
+constexpr uint8_t kHeadMidiCcLsb = kHeadMidiCcMsb + 32;
+constexpr float kHeadMidiScale = static_cast<float>(M_PI) / 8192.0f;
 
-// Maximum number of emitters supported
-constexpr int kMaxEmitters = 8;
+// Specification indices
+enum {
+    kSpecEmitters,
+    kSpecCoeffTable,     // shelf/notch table points per grid, 0 = exact trig
+    kSpecHeadModel,      // kHrtfModels entry for the HRIR / Ambisonic render modes
+    kSpecAmbiOrder,      // Ambisonic bus order, 1…kAmbiMaxOrder
+    kSpecMaxDistance,    // m; Distance range and reflection buffer length
+    kSpecCvEmitters,     // emitters with position CV inputs, 0…kMaxCvEmitters
+    kSpecSpeakers,       // speaker busses for the Speakers render mode, 0…kVbapMaxSpeakers
+};
 
 // Forward declarations
 static const char* const enumStringsAutoSpread[] = {
@@ -72,6 +75,36 @@ static const char* const enumStringsAutoSpread[] = {
     "On"
 };
 
+static const char* const enumStringsEngine[] = {
+    "Per-emitter",
+    "Lanes"
+};
+
+static const char* const enumStringsRenderMode[] = {
+    "Parametric",
+    "HRIR",
+    "Ambisonic",
+    "Speakers"
+};
+
+static const char* const enumStringsDelayInterp[] = {
+    "Linear",
+    "Lagrange",
+    "Thiran"
+};
+
+static const char* const enumStringsFilter[] = {
+    "Biquad",
+    "SVF"
+};
+
+static const char* const enumStringsQuality[] = {
+    "Full",
+    "No notch",
+    "No reflection",
+    "Direct"
+};
+
 static const _NT_parameter commonParameters[] = {
     {.name = "Auto Spread",
      .min = 0,
@@ -80,6 +113,104 @@ static const _NT_parameter commonParameters[] = {
      .unit = kNT_unitEnum,
      .scaling = 0,
      .enumStrings = enumStringsAutoSpread},
+    {.name = "Engine",
+     .min = 0,
+     .max = 1,
+     .def = 0,
+     .unit = kNT_unitEnum,
+     .scaling = 0,
+     .enumStrings = enumStringsEngine},
+    {.name = "Render mode",
+     .min = 0,
+     .max = 3,
+     .def = 0,
+     .unit = kNT_unitEnum,
+     .scaling = 0,
+     .enumStrings = enumStringsRenderMode},
+    {.name = "Delay interp",
+     .min = 0,
+     .max = kNumDelayInterps - 1,
+     .def = kInterpLinear,
+     .unit = kNT_unitEnum,
+     .scaling = 0,
+     .enumStrings = enumStringsDelayInterp},
+    {.name = "Filter",
+     .min = 0,
+     .max = kNumSpatialFilters - 1,
+     .def = kFilterBiquad,
+     .unit = kNT_unitEnum,
+     .scaling = 0,
+     .enumStrings = enumStringsFilter},
+    {.name = "Quality",
+     .min = 0,
+     .max = kNumSpatialQualities - 1,
+     .def = kQualityFull,
+     .unit = kNT_unitEnum,
+     .scaling = 0,
+     .enumStrings = enumStringsQuality},
+    {.name = "CPU budget",
+     .min = 1,
+     .max = kMaxEmitters,
+     .def = kMaxEmitters,
+     .unit = kNT_unitNone,
+     .scaling = 0,
+     .enumStrings = nullptr},
+    {.name = "Reverb",
+     .min = -40,
+     .max = 0,
+     .def = -40,
+     .unit = kNT_unitDb_minInf,
+     .scaling = 0,
+     .enumStrings = nullptr},
+    {.name = "Reverb time",
+     .min = 2,
+     .max = 100,
+     .def = 15,
+     .unit = kNT_unitSeconds,
+     .scaling = kNT_scaling10,
+     .enumStrings = nullptr},
+    {.name = "Reverb damping",
+     .min = 0,
+     .max = 100,
+     .def = 50,
+     .unit = kNT_unitPercent,
+     .scaling = 0,
+     .enumStrings = nullptr},
+    {.name = "CV interval",
+     .min = 4,
+     .max = 64,
+     .def = 32,
+     .unit = kNT_unitFrames,
+     .scaling = 0,
+     .enumStrings = nullptr},
+    {.name = "Head yaw",
+     .min = -180,
+     .max = 180,
+     .def = 0,
+     .unit = kNT_unitNone,
+     .scaling = 0,
+     .enumStrings = nullptr},
+    {.name = "Head pitch",
+     .min = -90,
+     .max = 90,
+     .def = 0,
+     .unit = kNT_unitNone,
+     .scaling = 0,
+     .enumStrings = nullptr},
+    {.name = "Head roll",
+     .min = -180,
+     .max = 180,
+     .def = 0,
+     .unit = kNT_unitNone,
+     .scaling = 0,
+     .enumStrings = nullptr},
+    {.name = "Head MIDI ch",
+     .min = 0,
+     .max = 16,
+     .def = 0,
+     .unit = kNT_unitNone,
+     .scaling = 0,
+     .enumStrings = nullptr},
 };
 
 static const _NT_parameter routingParameters[] = {
@@ -96,22 +227,88 @@ static const _NT_parameter perEmitterParameters[] = {
     {.name = "Gain", .min = -60, .max = 0, .def = 0, .unit = kNT_unitDb, .scaling = 0, .enumStrings = nullptr},
 };
 
-static const char* const emitterPageNames[] = {
-    "Emitter 1", "Emitter 2", "Emitter 3", "Emitter 4",
-    "Emitter 5", "Emitter 6", "Emitter 7", "Emitter 8"
+// Shown on the emitter's page, numbered after every emitter's block
+static const _NT_parameter cvParameters[] = {
+    {.name = "Azimuth CV", .min = 0, .max = 28, .def = 0, .unit = kNT_unitCvInput, .scaling = 0, .enumStrings = nullptr},
+    {.name = "Elevation CV", .min = 0, .max = 28, .def = 0, .unit = kNT_unitCvInput, .scaling = 0, .enumStrings = nullptr},
+    {.name = "Distance CV", .min = 0, .max = 28, .def = 0, .unit = kNT_unitCvInput, .scaling = 0, .enumStrings = nullptr},
+};
+
+// One set per speaker on the Speakers page, numbered after the CV block;
+// the constructor names them and lays the defaults out as a ring
+static const _NT_parameter speakerParameters[] = {
+    {.name = "Speaker", .min = 1, .max = 28, .def = 13, .unit = kNT_unitAudioOutput, .scaling = 0, .enumStrings = nullptr},
+    {.name = "Speaker azimuth", .min = -180, .max = 180, .def = 0, .unit = kNT_unitNone, .scaling = 0, .enumStrings = nullptr},
+    {.name = "Speaker elevation", .min = -90, .max = 90, .def = 0, .unit = kNT_unitNone, .scaling = 0, .enumStrings = nullptr},
+};
+
+static const char* const speakerNames[kVbapMaxSpeakers][3] = {
+    { "Speaker 1", "Speaker 1 azimuth", "Speaker 1 elevation" },
+    { "Speaker 2", "Speaker 2 azimuth", "Speaker 2 elevation" },
+    { "Speaker 3", "Speaker 3 azimuth", "Speaker 3 elevation" },
+    { "Speaker 4", "Speaker 4 azimuth", "Speaker 4 elevation" },
+    { "Speaker 5", "Speaker 5 azimuth", "Speaker 5 elevation" },
+    { "Speaker 6", "Speaker 6 azimuth", "Speaker 6 elevation" },
+    { "Speaker 7", "Speaker 7 azimuth", "Speaker 7 elevation" },
+    { "Speaker 8", "Speaker 8 azimuth", "Speaker 8 elevation" },
 };
 
-static const char* const emitterInputNames[] = {
-    "Emitter 1 Input", "Emitter 2 Input", "Emitter 3 Input", "Emitter 4 Input",
-    "Emitter 5 Input", "Emitter 6 Input", "Emitter 7 Input", "Emitter 8 Input"
+static const char* const emitterPageNames[kMaxEmitters] = {
+    "Emitter 1",  "Emitter 2",  "Emitter 3",  "Emitter 4",
+    "Emitter 5",  "Emitter 6",  "Emitter 7",  "Emitter 8",
+    "Emitter 9",  "Emitter 10", "Emitter 11", "Emitter 12",
+    "Emitter 13", "Emitter 14", "Emitter 15", "Emitter 16",
+    "Emitter 17", "Emitter 18", "Emitter 19", "Emitter 20",
+    "Emitter 21", "Emitter 22", "Emitter 23", "Emitter 24",
+    "Emitter 25", "Emitter 26", "Emitter 27", "Emitter 28",
+    "Emitter 29", "Emitter 30", "Emitter 31", "Emitter 32"
+};
+
+static const char* const emitterInputNames[kMaxEmitters] = {
+    "Emitter 1 Input",  "Emitter 2 Input",  "Emitter 3 Input",  "Emitter 4 Input",
+    "Emitter 5 Input",  "Emitter 6 Input",  "Emitter 7 Input",  "Emitter 8 Input",
+    "Emitter 9 Input",  "Emitter 10 Input", "Emitter 11 Input", "Emitter 12 Input",
+    "Emitter 13 Input", "Emitter 14 Input", "Emitter 15 Input", "Emitter 16 Input",
+    "Emitter 17 Input", "Emitter 18 Input", "Emitter 19 Input", "Emitter 20 Input",
+    "Emitter 21 Input", "Emitter 22 Input", "Emitter 23 Input", "Emitter 24 Input",
+    "Emitter 25 Input", "Emitter 26 Input", "Emitter 27 Input", "Emitter 28 Input",
+    "Emitter 29 Input", "Emitter 30 Input", "Emitter 31 Input", "Emitter 32 Input"
 };
 
 // Common parameter indices
 enum {
     kParamAutoSpread,
+    kParamEngine,
+    kParamRenderMode,
+    kParamDelayInterp,   // DelayInterp for the ITD / reflection taps
+    kParamFilter,        // SpatialFilter for the shelf / notch (per-emitter engine)
+    kParamQuality,       // SpatialQuality: stages the per-emitter kernel runs
+    kParamCpuBudget,     // full-quality emitter equivalents (per-emitter engine)
+    kParamReverb,        // shared reverb return, dB; the minimum turns it off
+    kParamReverbTime,    // RT60, s/10
+    kParamReverbDamping, // high-frequency decay, %
+    kParamCvInterval,    // frames between CV samples
+    kParamHeadYaw,       // listener orientation, degrees (Listener page)
+    kParamHeadPitch,
+    kParamHeadRoll,
+    kParamHeadMidi,      // MIDI channel of the head tracker, 0 = off
     kNumCommonParameters,
 };
 
+// Engine parameter values
+enum {
+    kEnginePerEmitter,   // applyMonoSpatialAudio once per emitter
+    kEngineLanes,        // applyMonoSpatialAudioLanes, kSpatialLanes emitters at a time
+};
+
+// Render mode parameter values
+enum {
+    kRenderParametric,   // shelf/notch HRTF approximation (Engine selects the kernel)
+    kRenderHrir,         // partitioned HRIR convolution, applyMonoHrirMix
+    kRenderAmbisonic,    // shared Ambisonic bus + one binaural decoder
+    kRenderSpeakers,     // VBAP to the speaker busses, applyMonoSpeakerMix
+};
+
 // Routing parameter indices
 enum {
     kParamOutputL = kNumCommonParameters,
@@ -130,13 +327,48 @@ enum {
     kNumPerEmitterParameters,
 };
 
-static const uint8_t commonParams[] = { kParamAutoSpread };
+// CV parameter indices, per CV emitter after the per-emitter blocks
+enum {
+    kParamCvAzimuth,
+    kParamCvElevation,
+    kParamCvDistance,
+    kNumCvParameters,
+};
+
+// Speaker parameter indices, per speaker after the CV block
+enum {
+    kParamSpeakerOutput,
+    kParamSpeakerAzimuth,
+    kParamSpeakerElevation,
+    kNumSpeakerParameters,
+};
+
+static_assert(kNumCommonParameters + kNumRoutingParameters + kMaxEmitters * kNumPerEmitterParameters +
+              kMaxCvEmitters * kNumCvParameters + kVbapMaxSpeakers * kNumSpeakerParameters <= 256,
+              "page parameter indices are 8-bit");
+
+static int cvParameterBase(int32_t numEmitters) {
+    return kNumCommonParameters + kNumRoutingParameters + numEmitters * kNumPerEmitterParameters;
+}
+
+static int speakerParameterBase(int32_t numEmitters, int32_t cvEmitters) {
+    return cvParameterBase(numEmitters) + cvEmitters * kNumCvParameters;
+}
+
+static const uint8_t commonParams[] = { kParamAutoSpread, kParamEngine, kParamRenderMode, kParamDelayInterp, kParamFilter,
+                                        kParamQuality, kParamCpuBudget, kParamReverb, kParamReverbTime, kParamReverbDamping,
+                                        kParamCvInterval };
 static const uint8_t routingParams[] = { kParamOutputL, kParamOutputMode, kParamOutputR };
+static const uint8_t listenerParams[] = { kParamHeadYaw, kParamHeadPitch, kParamHeadRoll, kParamHeadMidi };
 
 struct tinEarAlgorithm : _NT_algorithm {
-    tinEarAlgorithm(int32_t numEmitters_) 
-        : _NT_algorithm(), numEmitters(numEmitters_) {
-        pagesDefs.numPages = 2 + numEmitters;  // Common + Emitter pages + Routing page
+    tinEarAlgorithm(int32_t numEmitters_, int32_t maxDistance_, int32_t cvEmitters_, int32_t numSpeakers_)
+        : _NT_algorithm(), numEmitters(numEmitters_),
+          cvEmitters(cvEmitters_ < numEmitters_ ? cvEmitters_ : numEmitters_),
+          numSpeakers(numSpeakers_),
+          maxDistance(static_cast<float>(maxDistance_)) {
+        // Common + Emitter pages + Routing + Listener pages (+ Speakers page)
+        pagesDefs.numPages = 3 + numEmitters + (numSpeakers > 0 ? 1 : 0);
         pagesDefs.pages = pageDefs;
         
         // Copy common parameters
@@ -152,54 +384,131 @@ struct tinEarAlgorithm : _NT_algorithm {
             
             // Customize the input parameter name for this emitter
             parameterDefs[baseIdx + kParamEmitterInput].name = emitterInputNames[i];
-            parameterDefs[baseIdx + kParamEmitterInput].def = static_cast<int16_t>(1 + i);
+            parameterDefs[baseIdx + kParamEmitterInput].def = static_cast<int16_t>(1 + i % 12);   // physical inputs
+            parameterDefs[baseIdx + kParamEmitterDistance].max = static_cast<int16_t>(maxDistance_ * 10);
+        }
+        for (int i = 0; i < cvEmitters; ++i) {
+            memcpy(parameterDefs + cvParameterBase(numEmitters) + i * kNumCvParameters, cvParameters,
+                   kNumCvParameters * sizeof(_NT_parameter));
+        }
+
+        // Speakers default to consecutive outputs round an evenly spaced
+        // ring, the first left of front (a single speaker straight ahead)
+        for (int i = 0; i < numSpeakers; ++i) {
+            _NT_parameter *sp = parameterDefs + speakerParameterBase(numEmitters, cvEmitters) + i * kNumSpeakerParameters;
+            memcpy(sp, speakerParameters, kNumSpeakerParameters * sizeof(_NT_parameter));
+            for (int j = 0; j < kNumSpeakerParameters; ++j) {
+                sp[j].name = speakerNames[i][j];
+            }
+            float az = (numSpeakers > 1) ? 180.0f / numSpeakers - i * 360.0f / numSpeakers : 0.0f;
+            az += (az < -180.0f) ? 360.0f : 0.0f;
+            sp[kParamSpeakerOutput].def = static_cast<int16_t>(13 + i);
+            sp[kParamSpeakerAzimuth].def = static_cast<int16_t>(floorf(az + 0.5f));
         }
         
         // Create Common page (page 0)
         pageDefs[0].name = "Common";
-        pageDefs[0].numParams = kNumCommonParameters;
+        pageDefs[0].numParams = ARRAY_SIZE(commonParams);
         pageDefs[0].params = commonParams;
         
         // Create emitter pages (pages 1 to numEmitters)
         for (int i = 0; i < numEmitters; ++i) {
+            const int cv = (i < cvEmitters) ? kNumCvParameters : 0;
             pageDefs[i + 1].name = emitterPageNames[i];
-            pageDefs[i + 1].numParams = kNumPerEmitterParameters;
-            uint8_t* p = pageParams + i * kNumPerEmitterParameters;
+            pageDefs[i + 1].numParams = kNumPerEmitterParameters + cv;
+            uint8_t* p = pageParams + i * (kNumPerEmitterParameters + kNumCvParameters);
             pageDefs[i + 1].params = p;
             for (int j = 0; j < kNumPerEmitterParameters; ++j) {
                 p[j] = kNumCommonParameters + kNumRoutingParameters + i * kNumPerEmitterParameters + j;
             }
+            for (int j = 0; j < cv; ++j) {
+                p[kNumPerEmitterParameters + j] = cvParameterBase(numEmitters) + i * kNumCvParameters + j;
+            }
         }
         
-        // Create routing page (last page)
+        // Create routing page
         pageDefs[numEmitters + 1].name = "Routing";
         pageDefs[numEmitters + 1].numParams = kNumRoutingParameters;
         pageDefs[numEmitters + 1].params = routingParams;
+
+        pageDefs[numEmitters + 2].name = "Listener";
+        pageDefs[numEmitters + 2].numParams = ARRAY_SIZE(listenerParams);
+        pageDefs[numEmitters + 2].params = listenerParams;
+
+        // Speakers page (last, when there are speakers)
+        pageDefs[numEmitters + 3].name = "Speakers";
+        pageDefs[numEmitters + 3].numParams = numSpeakers * kNumSpeakerParameters;
+        pageDefs[numEmitters + 3].params = speakerPageParams;
+        for (int j = 0; j < numSpeakers * kNumSpeakerParameters; ++j) {
+            speakerPageParams[j] = speakerParameterBase(numEmitters, cvEmitters) + j;
+        }
         
         // Set algorithm members
         parameters = parameterDefs;
         parameterPages = &pagesDefs;
+
+        // 0 dB until the first attenuation change
+        for (int i = 0; i < kMaxEmitters; ++i) {
+            startGain[i] = currentGain[i] = targetGain[i] = 1.0f;
+        }
     }
 
     ~tinEarAlgorithm() = default;
     
-    // Number of emitters for this instance
+    // Number of emitters for this instance, and how many of them (the
+    // first) have CV inputs
     int32_t numEmitters;
+    int32_t cvEmitters;
+
+    // Speaker busses for the Speakers render mode (0: the mode renders
+    // parametric), their VBAP layout, and per emitter the base it was
+    // last panned in and its speaker gains × output gain at the end of
+    // the last block
+    int32_t numSpeakers;
+    VbapLayout speakerLayout;
+    int vbapBase[kMaxEmitters] = {};
+    float speakerGains[kMaxEmitters][kVbapMaxSpeakers] = {};
+    float speakerTarget[kMaxEmitters][kVbapMaxSpeakers] = {};   // this block's end
+
+    // Distance range, m
+    float maxDistance;
 
     // Per-emitter data arrays (sized for max emitters)
     float targetAzimuth[kMaxEmitters] = {};
     float targetElevation[kMaxEmitters] = {};
     float targetDistance[kMaxEmitters] = {};
     float targetAttenuation[kMaxEmitters] = {};  // in dB
+    float targetGain[kMaxEmitters] = {};         // linear
     
     float currentAzimuth[kMaxEmitters] = {};
     float currentElevation[kMaxEmitters] = {};
     float currentDistance[kMaxEmitters] = {};
-    float currentAttenuation[kMaxEmitters] = {};  // in dB
     
     float sourceX[kMaxEmitters] = {};
     float sourceY[kMaxEmitters] = {};
     float sourceZ[kMaxEmitters] = {};
+
+    // The same position in the parametric kernel's polar form
+    SpatialPolar sourcePolar[kMaxEmitters] = {};
+
+    // CV offsets (rad, rad, m) added after the glides, sampled every
+    // CV interval frames; step() renders in sub-blocks of that length
+    // while any CV input is assigned, so the kernels' per-block ramps
+    // interpolate between samples
+    float cvAzimuth[kMaxEmitters] = {};
+    float cvElevation[kMaxEmitters] = {};
+    float cvDistance[kMaxEmitters] = {};
+    bool cvAssigned = false;
+
+    // Listener orientation: MIDI head-tracker angles (rad) and raw 14-bit
+    // values, and the head's left / up / front axes in scene coordinates,
+    // rebuilt once per block.  Emitters rotate into head coordinates
+    // after their control update while headRotated; the kernels' ramps
+    // interpolate the rotation across the block.
+    float headMidi[3] = {};
+    uint16_t headMidiRaw[3] = { 8192, 8192, 8192 };
+    float headAxes[3][3] = {};
+    bool headRotated = false;
     
     // Auto-spread enabled flag
     bool autoSpreadEnabled = false;
@@ -207,62 +516,350 @@ struct tinEarAlgorithm : _NT_algorithm {
     // Per-emitter spatial audio state (allocated in DTC memory)
     SpatialAudioState* spatialStates = nullptr;
 
-    // Slew limiting - smooth over approximately 20ms at 48kHz
-    static constexpr float SLEW_RATE = 0.001f;
+    // Structure-of-arrays filter state for the lane engine, one bank per
+    // kSpatialLanes emitters (allocated in DTC memory after spatialStates)
+    SpatialLaneBank* laneBanks = nullptr;
+    int engine = kEnginePerEmitter;
+
+    // HRIR render mode: shared renderer (FFT + dataset view) and
+    // per-emitter convolution state in DRAM; nullptr if the head model
+    // failed to bind, which leaves the parametric path in use
+    HrirRenderer* hrirRenderer = nullptr;
+    HrirEmitterState* hrirStates = nullptr;
+    int renderMode = kRenderParametric;
+
+    // Ambisonic render mode: bus + binaural decoder in DRAM (nullptr with
+    // the HRIR renderer), and each emitter's channel gains × output gain
+    // at the end of the last block – the next block ramps from them
+    AmbiDecoder* ambiDecoder = nullptr;
+    float ambiGains[kMaxEmitters][kAmbiMaxChannels] = {};
+    float ambiTarget[kMaxEmitters][kAmbiMaxChannels] = {};   // this block's end
+
+    // Shelf/notch coefficient grids shared by all emitters; storage
+    // follows the algorithm object in SRAM.  Unused when size() == 0.
+    SpatialCoeffTable coeffTable;
+
+    // Rate-dependent constants shared by all emitters, rebuilt (with the
+    // coefficient grids) when NT_globals.sampleRate changes
+    SpatialRate rate;
+    uint32_t sampleRate = 0;
+
+    // Glide decay per frame, as a base-2 exponent, and kGlideSpeed per
+    // frame, at the current rate
+    float glideRate = 0.0f;
+    float glideStep = 0.0f;
+
+    // Linear output gain at the start and end of this block
+    float startGain[kMaxEmitters] = {};
+    float currentGain[kMaxEmitters] = {};
 
-    // Audio processing buffers for spatial audio
-    static const int MAX_BUFFER_SIZE = 256;
-    float tempOutputL[MAX_BUFFER_SIZE]{};
-    float tempOutputR[MAX_BUFFER_SIZE]{};
+    // Activity detection: samples each emitter has been quiet for, the
+    // quiet time after which its delay history, filters and convolution
+    // tails have decayed (rate dependent), and the number of emitters
+    // rendered in the last block
+    uint32_t quietSamples[kMaxEmitters] = {};
+    uint32_t idleTailSamples = 0;
+    uint32_t reflectionLength = 0;      // samples per emitter, 0 if unbound
+    int activeEmitters = 0;
+
+    // Level of detail: per-emitter input peak envelope for ranking
+    float levelEnvelope[kMaxEmitters] = {};
+
+    // Shared late reverb: one FDN (lines in DRAM) fed by a mono send bus
+    // in DTC that every active emitter adds into.  reverbSend holds each
+    // emitter's send gain at the end of the last block; the wet gain
+    // ramps from reverbWet to reverbTarget, and the network only runs
+    // while either is non-zero.
+    FdnReverb reverb;
+    float* reverbBus = nullptr;
+    uint32_t reverbBusFrames = 0;
+    float* reverbStereo = nullptr;      // L/R scratch the Speakers mode spreads out
+    float reverbSend[kMaxEmitters] = {};
+    float reverbWet = 0.0f;
+    float reverbTarget = 0.0f;
+    bool reverbRunning = false;         // this block
+
+#if TINEAR_PROFILE
+    // Stage timings for the load meter in draw()
+    TinearProfile profile;
+#endif
     
     // Dynamic parameter storage
-    _NT_parameter parameterDefs[kNumCommonParameters + kNumRoutingParameters + kMaxEmitters * kNumPerEmitterParameters];
+    _NT_parameter parameterDefs[kNumCommonParameters + kNumRoutingParameters + kMaxEmitters * kNumPerEmitterParameters +
+                                kMaxCvEmitters * kNumCvParameters + kVbapMaxSpeakers * kNumSpeakerParameters];
     _NT_parameterPages pagesDefs;
-    _NT_parameterPage pageDefs[2 + kMaxEmitters];  // Common + Emitter pages + Routing
-    uint8_t pageParams[kMaxEmitters * kNumPerEmitterParameters];
+    _NT_parameterPage pageDefs[4 + kMaxEmitters];  // Common + Emitter pages + Routing + Listener + Speakers
+    uint8_t pageParams[kMaxEmitters * (kNumPerEmitterParameters + kNumCvParameters)];
+    uint8_t speakerPageParams[kVbapMaxSpeakers * kNumSpeakerParameters];
     
 
-    // Slew limiting function
-    static float slewLimit(float current, float target, float rate) {
-        float diff = target - current;
-        if (diff > rate) {
-            return current + rate;
-        } else if (diff < -rate) {
-            return current - rate;
-        }
-        return target;
-    }
-    
     // Convert dB to linear gain
     static float dbToLinear(float db) {
-        return powf(10.0f, db / 20.0f);
+        return fastDbToGain(db);
     }
 };
 
 
+// Coefficient table storage is placed right after the algorithm object
+static constexpr uint32_t kCoeffTableOffset = (sizeof(tinEarAlgorithm) + 7u) & ~7u;
+
+// Instance-independent data in the factory's static DRAM, built once per
+// plugin load by initialise() and shared by every instance: the
+// synthesised spherical head model, and the coefficient grids at
+// kMaxPoints, which any Coeff table whose points − 1 divides 128 reads
+// in place.  Instances keep their own copies if initialise() never ran.
+// The grids follow rate changes; the spherical model stays at the load
+// rate, since live instances may be reading it (and its synthesis
+// scratch overlaps the grids), so instances constructed at another rate
+// synthesise their own.
+struct TinearStatic {
+    const uint8_t *hrtfBlob = nullptr;   // spherical model, at hrtfRate
+    uint32_t hrtfBytes = 0;              // 0 if synthesis failed
+    uint32_t hrtfRate = 0;
+    void *gridStorage = nullptr;
+    uint32_t tableRate = 0;              // rate the grids were built for
+    SpatialCoeffTable table;
+};
+static TinearStatic *sStatic = nullptr;
+
+// Static layout: TinearStatic, the spherical blob, then the grids (the
+// synthesis scratch overlaps them until they are built)
+static constexpr uint32_t kStaticBlobOffset = (sizeof(TinearStatic) + 15u) & ~15u;
+
+static uint32_t staticGridOffset() {
+    return (kStaticBlobOffset + hrtfSphericalBlobBytes() + 15u) & ~15u;
+}
+
+void calculateStaticRequirements(_NT_staticRequirements &req) {
+    const uint32_t grids = SpatialCoeffTable::storageBytes(SpatialCoeffTable::kMaxPoints);
+    req.dram = staticGridOffset() + (grids > sizeof(HrtfBuildScratch) ? grids : sizeof(HrtfBuildScratch));
+}
+
+void initialise(_NT_staticMemoryPtrs &ptrs, const _NT_staticRequirements &) {
+    if (!ptrs.dram)
+        return;
+    auto *st = new(ptrs.dram) TinearStatic;
+    uint8_t *grids = ptrs.dram + staticGridOffset();
+    auto *scratch = new(grids) HrtfBuildScratch;
+    st->hrtfBlob = ptrs.dram + kStaticBlobOffset;
+    st->hrtfBytes = hrtfSynthesiseSpherical(ptrs.dram + kStaticBlobOffset, *scratch,
+                                            static_cast<float>(NT_globals.sampleRate));
+    st->hrtfRate = NT_globals.sampleRate;
+
+    SpatialRate rate;
+    rate.set(static_cast<float>(NT_globals.sampleRate));
+    st->gridStorage = grids;
+    st->table.init(grids, SpatialCoeffTable::kMaxPoints, rate);
+    st->tableRate = NT_globals.sampleRate;
+    sStatic = st;
+}
+
+static bool sharesCoeffTable(int points) {
+    return sStatic && SpatialCoeffTable::viewable(SpatialCoeffTable::kMaxPoints, points);
+}
+
+// Views the shared grids, or builds the instance's own after the
+// algorithm object.  The first instance to run at a new rate rebuilds
+// the shared grids for everyone.
+static void bindCoeffTable(tinEarAlgorithm *pThis, int points) {
+    if (sharesCoeffTable(points)) {
+        if (sStatic->tableRate != pThis->sampleRate) {
+            sStatic->table.init(sStatic->gridStorage, SpatialCoeffTable::kMaxPoints, pThis->rate);
+            sStatic->tableRate = pThis->sampleRate;
+        }
+        pThis->coeffTable.view(sStatic->table, points);
+    } else {
+        pThis->coeffTable.init(reinterpret_cast<uint8_t *>(pThis) + kCoeffTableOffset, points, pThis->rate);
+    }
+}
+
+// The spherical head model is synthesised per instance only without a
+// shared copy at the current rate
+static bool sharesHrtfBlob(const HrtfModel& model) {
+    return !model.blob && sStatic && sStatic->hrtfBytes > 0 &&
+           sStatic->hrtfRate == NT_globals.sampleRate;
+}
+
+// Recomputes everything that depends on the sample rate.  Runs at
+// construct and from step() when the host rate changes, never per block.
+static void applySampleRate(tinEarAlgorithm *pThis, uint32_t sampleRate) {
+    pThis->sampleRate = sampleRate;
+    pThis->rate.set(static_cast<float>(sampleRate));
+    pThis->reverb.setRate(pThis->rate);
+    pThis->glideRate = 1.4426950f / (kGlideTime * sampleRate);          // log2(e) / frames
+    pThis->glideStep = kGlideSpeed / sampleRate;
+    // Longest delay tap plus 50 ms for the filters to ring down
+    pThis->idleTailSamples = pThis->reflectionLength + kItdHistory + sampleRate / 20;
+#if TINEAR_PROFILE
+    pThis->profile.windowFrames = sampleRate / 4;
+#endif
+    if (pThis->coeffTable.size() > 0) {
+        bindCoeffTable(pThis, pThis->coeffTable.size());
+    }
+}
+
+// Lane banks follow the emitter states in DTC, vector-aligned
+static uint32_t laneBankOffset(int32_t numEmitters) {
+    constexpr uint32_t kAlign = alignof(SpatialLaneBank);
+    return (numEmitters * sizeof(SpatialAudioState) + kAlign - 1) & ~(kAlign - 1);
+}
+
+static int32_t numLaneGroups(int32_t numEmitters) {
+    return (numEmitters + kSpatialLanes - 1) / kSpatialLanes;
+}
+
+// DRAM layout: HrirRenderer, per-emitter HRIR states, then the HRTF
+// blob when the head model is synthesised rather than compiled in
+static constexpr uint32_t kHrirStatesOffset = (sizeof(HrirRenderer) + 15u) & ~15u;
+
+static uint32_t hrtfBlobOffset(int32_t numEmitters) {
+    return kHrirStatesOffset + numEmitters * sizeof(HrirEmitterState);
+}
+
+static uint32_t ambiDecoderOffset(int32_t numEmitters, const HrtfModel& model) {
+    uint32_t end = hrtfBlobOffset(numEmitters) + (model.blob || sharesHrtfBlob(model) ? 0 : hrtfSphericalBlobBytes());
+    return (end + 15u) & ~15u;
+}
+
+// …then the decoder's channel histories and filters, sized for the Ambi
+// order specification
+static uint32_t ambiStorageOffset(int32_t numEmitters, const HrtfModel& model) {
+    return (ambiDecoderOffset(numEmitters, model) + sizeof(AmbiDecoder) + 15u) & ~15u;
+}
+
+// Floor-reflection histories follow, one per emitter (DelayBuffer samples),
+// long enough for a source at Max distance at the current sample rate
+// (a later, higher rate clamps the furthest reflections)
+static uint32_t reflectionOffset(const int32_t *specifications, const HrtfModel& model) {
+    return (ambiStorageOffset(specifications[kSpecEmitters], model) +
+            AmbiDecoder::storageFloats(specifications[kSpecAmbiOrder]) * sizeof(float) + 15u) & ~15u;
+}
+
+static uint32_t reflectionLength(const int32_t *specifications) {
+    return reflectionHistoryLength(static_cast<float>(NT_globals.sampleRate),
+                                   static_cast<float>(specifications[kSpecMaxDistance]));
+}
+
+// …followed by the reverb's delay lines
+static uint32_t reverbOffset(const int32_t *specifications, const HrtfModel& model) {
+    int32_t numEmitters = specifications[kSpecEmitters];
+    return (reflectionOffset(specifications, model) +
+            numEmitters * reflectionLength(specifications) * DelayBuffer::kSampleBytes + 15u) & ~15u;
+}
+
+// The reverb send bus follows the lane banks in DTC
+static uint32_t reverbBusOffset(int32_t numEmitters) {
+    return laneBankOffset(numEmitters) + numLaneGroups(numEmitters) * sizeof(SpatialLaneBank);
+}
+
 void calculateRequirements(_NT_algorithmRequirements &req,
                            const int32_t *specifications) {
-    int32_t numEmitters = specifications[0];
+    int32_t numEmitters = specifications[kSpecEmitters];
+    int32_t tablePoints = specifications[kSpecCoeffTable];
+    const HrtfModel& model = kHrtfModels[specifications[kSpecHeadModel]];
     
-    req.numParameters = kNumCommonParameters + kNumRoutingParameters + numEmitters * kNumPerEmitterParameters;
-    req.sram = sizeof(tinEarAlgorithm);
-    req.dram = 0;
-    req.dtc = numEmitters * sizeof(SpatialAudioState);  // Allocate per-emitter spatial audio state
+    int32_t cvEmitters = specifications[kSpecCvEmitters];
+    int32_t numSpeakers = specifications[kSpecSpeakers];
+    req.numParameters = speakerParameterBase(numEmitters, cvEmitters < numEmitters ? cvEmitters : numEmitters) +
+                        numSpeakers * kNumSpeakerParameters;
+    req.sram = kCoeffTableOffset;
+    if (tablePoints > 0 && !sharesCoeffTable(tablePoints)) {
+        req.sram += SpatialCoeffTable::storageBytes(tablePoints);
+    }
+    req.dram = reverbOffset(specifications, model) +
+               FdnReverb::storageFloats(static_cast<float>(NT_globals.sampleRate)) * sizeof(float);
+    // Per-emitter spatial audio state (filters, ITD history), the lane
+    // engine's SoA banks, then the reverb send bus (and, with speakers,
+    // the reverb's stereo output for the speaker mode to spread)
+    req.dtc = reverbBusOffset(numEmitters) +
+              (numSpeakers > 0 ? 3 : 1) * NT_globals.maxFramesPerStep * sizeof(float);
     req.itc = 0;
 }
 
 _NT_algorithm *construct(const _NT_algorithmMemoryPtrs &ptrs,
                          const _NT_algorithmRequirements &,  // unused
                          const int32_t *specifications) {
-    int32_t numEmitters = specifications[0];
+    int32_t numEmitters = specifications[kSpecEmitters];
+    int32_t tablePoints = specifications[kSpecCoeffTable];
+    const HrtfModel& model = kHrtfModels[specifications[kSpecHeadModel]];
     
-    auto *alg = new(ptrs.sram) tinEarAlgorithm(numEmitters);
+    auto *alg = new(ptrs.sram) tinEarAlgorithm(numEmitters, specifications[kSpecMaxDistance],
+                                               specifications[kSpecCvEmitters],
+                                               specifications[kSpecSpeakers]);
+    if (ptrs.dram && numEmitters > 0) {
+        alg->reflectionLength = reflectionLength(specifications);
+    }
+
+    // Rate constants and shelf/notch coefficient grids for the current rate
+    applySampleRate(alg, NT_globals.sampleRate);
+#if TINEAR_PROFILE
+    profileEnable();
+#endif
+    if (tablePoints > 0) {
+        bindCoeffTable(alg, tablePoints);
+    }
     
     // Initialize per-emitter spatial audio states in DTC memory
     if (ptrs.dtc && numEmitters > 0) {
         alg->spatialStates = reinterpret_cast<SpatialAudioState*>(ptrs.dtc);
         for (int i = 0; i < numEmitters; ++i) {
             new(&alg->spatialStates[i]) SpatialAudioState();
+            alg->spatialStates[i].rate = &alg->rate;
+            if (tablePoints > 0) {
+                alg->spatialStates[i].coeffTable = &alg->coeffTable;
+            }
+#if TINEAR_PROFILE
+            alg->spatialStates[i].profile = &alg->profile;
+#endif
+            if (alg->reflectionLength > 0) {
+                uint8_t *storage = ptrs.dram + reflectionOffset(specifications, model) +
+                                   i * alg->reflectionLength * DelayBuffer::kSampleBytes;
+                alg->spatialStates[i].reflHistory.bind(storage, alg->reflectionLength);
+            }
+        }
+
+        alg->laneBanks = reinterpret_cast<SpatialLaneBank*>(ptrs.dtc + laneBankOffset(numEmitters));
+        for (int g = 0; g < numLaneGroups(numEmitters); ++g) {
+            new(&alg->laneBanks[g]) SpatialLaneBank();
+        }
+
+        if (ptrs.dram) {
+            alg->reverbBus = reinterpret_cast<float*>(ptrs.dtc + reverbBusOffset(numEmitters));
+            alg->reverbBusFrames = NT_globals.maxFramesPerStep;
+            if (alg->numSpeakers > 0) {
+                alg->reverbStereo = alg->reverbBus + NT_globals.maxFramesPerStep;
+            }
+            alg->reverb.init(reinterpret_cast<float*>(ptrs.dram + reverbOffset(specifications, model)),
+                             static_cast<float>(NT_globals.sampleRate));
+        }
+    }
+
+    // HRIR renderer: compiled-in head models are bound in place, the
+    // spherical model from static memory (or synthesised into DRAM)
+    if (ptrs.dram && numEmitters > 0) {
+        auto *renderer = new(ptrs.dram) HrirRenderer();
+        const void* blob = model.blob;
+        uint32_t bytes = model.bytes;
+        if (sharesHrtfBlob(model)) {
+            blob = sStatic->hrtfBlob;
+            bytes = sStatic->hrtfBytes;
+        } else if (!blob) {
+            blob = ptrs.dram + hrtfBlobOffset(numEmitters);
+            bytes = hrtfSynthesiseSpherical(ptrs.dram + hrtfBlobOffset(numEmitters), renderer->work,
+                                            static_cast<float>(NT_globals.sampleRate));
+        }
+        if (renderer->init(blob, bytes)) {
+            alg->hrirRenderer = renderer;
+            alg->hrirStates = reinterpret_cast<HrirEmitterState*>(ptrs.dram + kHrirStatesOffset);
+            for (int i = 0; i < numEmitters; ++i) {
+                new(&alg->hrirStates[i]) HrirEmitterState();
+            }
+
+            // SH-domain filters come from the same dataset
+            alg->ambiDecoder = new(ptrs.dram + ambiDecoderOffset(numEmitters, model)) AmbiDecoder;
+            alg->ambiDecoder->init(specifications[kSpecAmbiOrder],
+                                   reinterpret_cast<float*>(ptrs.dram + ambiStorageOffset(numEmitters, model)),
+                                   renderer);
         }
     }
     
@@ -285,6 +882,131 @@ void parameterChanged(_NT_algorithm *self, int p) {
         }
     }
     
+    if (p == kParamEngine) {
+        // Filter state isn't shared between engines; start the new one clean.
+        pThis->engine = pThis->v[kParamEngine];
+        if (pThis->engine == kEngineLanes && pThis->laneBanks) {
+            for (int g = 0; g < numLaneGroups(pThis->numEmitters); ++g) {
+                pThis->laneBanks[g].clear();
+            }
+        }
+    }
+    
+    if (p == kParamRenderMode) {
+        // Flush stale partitions so the convolution restarts from silence
+        pThis->renderMode = pThis->v[kParamRenderMode];
+        if (pThis->renderMode == kRenderHrir && pThis->hrirStates) {
+            for (int i = 0; i < pThis->numEmitters; ++i) {
+                pThis->hrirStates[i].clear();
+            }
+        }
+        if (pThis->renderMode == kRenderAmbisonic && pThis->ambiDecoder) {
+            // Emitters fade in from silence over the first block
+            pThis->ambiDecoder->clear();
+            memset(pThis->ambiGains, 0, sizeof(pThis->ambiGains));
+        }
+        if (pThis->renderMode == kRenderSpeakers) {
+            memset(pThis->speakerGains, 0, sizeof(pThis->speakerGains));
+        }
+    }
+    
+    if (p == kParamHeadMidi) {
+        // A new (or no) tracker starts from the parameters alone
+        for (int k = 0; k < 3; ++k) {
+            pThis->headMidi[k] = 0.0f;
+            pThis->headMidiRaw[k] = 8192;
+        }
+    }
+
+    if (p == kParamDelayInterp && pThis->spatialStates) {
+        // Allpass taps carry state from the previous reader; drop it
+        DelayInterp interp = static_cast<DelayInterp>(pThis->v[kParamDelayInterp]);
+        for (int i = 0; i < pThis->numEmitters; ++i) {
+            SpatialAudioState& st = pThis->spatialStates[i];
+            st.interp = interp;
+            setSpatialKernel(&st);
+            st.tapL.clear(); st.tapR.clear();
+            st.reflTapL.clear(); st.reflTapR.clear();
+            if (pThis->hrirStates) {
+                pThis->hrirStates[i].itdTapL.clear();
+                pThis->hrirStates[i].itdTapR.clear();
+            }
+        }
+    }
+    
+    if (p == kParamReverb) {
+        // The network restarts from silence when turned back on; turning
+        // it off lets the wet gain fade before it stops
+        const float target = (pThis->v[kParamReverb] > -40) ? tinEarAlgorithm::dbToLinear(pThis->v[kParamReverb]) : 0.0f;
+        if (target > 0.0f && pThis->reverbTarget == 0.0f && pThis->reverbWet == 0.0f) {
+            pThis->reverb.clear();
+            memset(pThis->reverbSend, 0, sizeof(pThis->reverbSend));
+        }
+        pThis->reverbTarget = target;
+    }
+
+    if (p == kParamReverbTime || p == kParamReverbDamping) {
+        pThis->reverb.setDecay(pThis->v[kParamReverbTime] / 10.0f, pThis->v[kParamReverbDamping] / 100.0f);
+    }
+
+    if (p == kParamFilter && pThis->spatialStates) {
+        // The SVFs start clean; the biquads resume with the coefficients
+        // they stopped with and smooth on from there
+        SpatialFilter filter = static_cast<SpatialFilter>(pThis->v[kParamFilter]);
+        for (int i = 0; i < pThis->numEmitters; ++i) {
+            SpatialAudioState& st = pThis->spatialStates[i];
+            if (filter == kFilterSvf && st.filter != kFilterSvf) {
+                st.svfShelfL.clear(); st.svfShelfR.clear();
+                st.svfNotchL.clear(); st.svfNotchR.clear();
+            }
+            st.filter = filter;
+            setSpatialKernel(&st);
+        }
+    }
+
+    if (p == kParamQuality && pThis->spatialStates) {
+        // Each emitter's kernel is the specialisation without the
+        // stages left out, so they cost nothing
+        SpatialQuality quality = static_cast<SpatialQuality>(pThis->v[kParamQuality]);
+        for (int i = 0; i < pThis->numEmitters; ++i) {
+            setSpatialQuality(&pThis->spatialStates[i], quality);
+        }
+    }
+
+    // Speaker directions rebuild the panning bases; the outputs are
+    // read in renderSpeakers()
+    const int speakerBase = speakerParameterBase(pThis->numEmitters, pThis->cvEmitters);
+    if (p >= speakerBase) {
+        if ((p - speakerBase) % kNumSpeakerParameters != kParamSpeakerOutput) {
+            float azimuth[kVbapMaxSpeakers], elevation[kVbapMaxSpeakers];
+            for (int i = 0; i < pThis->numSpeakers; ++i) {
+                azimuth[i] = pThis->v[speakerBase + i * kNumSpeakerParameters + kParamSpeakerAzimuth];
+                elevation[i] = pThis->v[speakerBase + i * kNumSpeakerParameters + kParamSpeakerElevation];
+            }
+            pThis->speakerLayout.build(azimuth, elevation, pThis->numSpeakers);
+        }
+        return;
+    }
+
+    // CV inputs are read in step(); an unassigned one stops offsetting
+    // its emitter, and with none assigned step() renders whole blocks
+    if (p >= cvParameterBase(pThis->numEmitters)) {
+        const int emitterIdx = (p - cvParameterBase(pThis->numEmitters)) / kNumCvParameters;
+        if (pThis->v[p] == 0) {
+            switch ((p - cvParameterBase(pThis->numEmitters)) % kNumCvParameters) {
+                case kParamCvAzimuth: pThis->cvAzimuth[emitterIdx] = 0.0f; break;
+                case kParamCvElevation: pThis->cvElevation[emitterIdx] = 0.0f; break;
+                case kParamCvDistance: pThis->cvDistance[emitterIdx] = 0.0f; break;
+            }
+        }
+        pThis->cvAssigned = false;
+        for (int i = 0; i < pThis->cvEmitters * kNumCvParameters; ++i) {
+            if (pThis->v[cvParameterBase(pThis->numEmitters) + i] != 0)
+                pThis->cvAssigned = true;
+        }
+        return;
+    }
+
     // Handle per-emitter parameters
     if (p >= kNumCommonParameters + kNumRoutingParameters) {
         int relativeIdx = p - (kNumCommonParameters + kNumRoutingParameters);
@@ -316,93 +1038,685 @@ void parameterChanged(_NT_algorithm *self, int p) {
                     
                 case kParamEmitterAttenuation:
                     pThis->targetAttenuation[emitterIdx] = pThis->v[p];
+                    pThis->targetGain[emitterIdx] = tinEarAlgorithm::dbToLinear(pThis->v[p]);
                     break;
             }
         }
     }
 }
 
-void step(_NT_algorithm *self, float *busFrames, int numFramesBy4) {
-    auto *pThis = (tinEarAlgorithm *) self;
-    const int numFrames = numFramesBy4 * 4;
+// Glide over one block: the remaining distance d to a target after
+// keep of it decays, landing on the target once within kGlideSnap
+static inline float glideRemaining(float d, float keep) {
+    d *= keep;
+    return (fabsf(d) < kGlideSnap) ? 0.0f : d;
+}
 
-    // Output channels
-    float *outL = busFrames + (pThis->v[kParamOutputL] - 1) * numFrames;
-    float *outR = busFrames + (pThis->v[kParamOutputR] - 1) * numFrames;
+// The same with the speed ceiling: beyond kGlideKnee the distance closes
+// at glideStep per frame (travel over the block), then decays from the
+// knee for whatever is left of the block
+static inline float glideRemaining(const tinEarAlgorithm *pThis, float d, float keep,
+                                   float travel, int numFrames) {
+    const float a = fabsf(d);
+    if (a <= kGlideKnee)
+        return glideRemaining(d, keep);
+    if (a - travel >= kGlideKnee)
+        return (d > 0.0f) ? d - travel : d + travel;
+    const float framesLeft = numFrames - (a - kGlideKnee) / pThis->glideStep;
+    const float r = kGlideKnee * fastExp2(-pThis->glideRate * framesLeft);
+    return (d > 0.0f) ? r : -r;
+}
 
-    // Output mode (0 = Add, 1 = Replace)
-    bool replaceMode = pThis->v[kParamOutputMode];
-    
-    // Clear output buffers if in replace mode
-    if (replaceMode) {
-        for (int i = 0; i < numFrames; ++i) {
-            outL[i] = 0.0f;
-            outR[i] = 0.0f;
+// Advances every emitter's glides to the end of this block.  Azimuth
+// glides the short way round; the kernels ramp linearly between the
+// block ends.
+static void glideControls(tinEarAlgorithm *pThis, int numFrames) {
+    const float keep = fastExp2(-pThis->glideRate * numFrames);
+    const float travel = pThis->glideStep * numFrames;
+    const float pi = static_cast<float>(M_PI);
+    for (int e = 0; e < pThis->numEmitters; ++e) {
+        float dAz = pThis->currentAzimuth[e] - pThis->targetAzimuth[e];
+        dAz += (dAz > pi) ? -2.0f * pi : (dAz < -pi) ? 2.0f * pi : 0.0f;
+        pThis->currentAzimuth[e] = pThis->targetAzimuth[e] +
+                                   glideRemaining(pThis, dAz, keep, travel, numFrames);
+        pThis->currentElevation[e] = pThis->targetElevation[e] +
+            glideRemaining(pThis, pThis->currentElevation[e] - pThis->targetElevation[e], keep, travel, numFrames);
+        pThis->currentDistance[e] = pThis->targetDistance[e] +
+            glideRemaining(pThis, pThis->currentDistance[e] - pThis->targetDistance[e], keep, travel, numFrames);
+        pThis->startGain[e] = pThis->currentGain[e];
+        pThis->currentGain[e] = pThis->targetGain[e] +
+                                glideRemaining(pThis->currentGain[e] - pThis->targetGain[e], keep);
+    }
+}
+
+// Per-block control update for one emitter, after glideControls: the
+// glided polar position plus CV converted to the engines' Cartesian
+// input and the parametric kernel's polar form, then into head
+// coordinates.
+static void updateEmitterControl(tinEarAlgorithm *pThis, int emitter) {
+    // Update source position based on smoothed angles plus CV; the
+    // clamps are no-ops without CV
+    const float azimuth = pThis->currentAzimuth[emitter] + pThis->cvAzimuth[emitter];
+    const float elevation = clampf(pThis->currentElevation[emitter] + pThis->cvElevation[emitter],
+                                   -1.5707964f, 1.5707964f);
+    const float distance = clampf(pThis->currentDistance[emitter] + pThis->cvDistance[emitter],
+                                  0.0f, pThis->maxDistance);
+    const float sinAz = fastSin(azimuth);
+    const float cosAz = fastCos(azimuth);
+    const float sinEl = fastSin(elevation);
+    const float cosEl = fastCos(elevation);
+    pThis->sourceX[emitter] = distance * cosEl * sinAz;
+    pThis->sourceZ[emitter] = distance * cosEl * cosAz;
+    pThis->sourceY[emitter] = distance * sinEl;
+
+    SpatialPolar &polar = pThis->sourcePolar[emitter];
+    polar.sinAz = sinAz;
+    polar.elevN = elevation * (2.0f / M_PI);
+    polar.dist = distance;
+    polar.height = pThis->sourceY[emitter];
+    if (!pThis->headRotated)
+        return;
+
+    // Into head coordinates: the position on each of the head's axes
+    const float (*axes)[3] = pThis->headAxes;
+    const float x = pThis->sourceX[emitter], y = pThis->sourceY[emitter], z = pThis->sourceZ[emitter];
+    const float hx = x * axes[0][0] + y * axes[0][1] + z * axes[0][2];
+    const float hy = x * axes[1][0] + y * axes[1][1] + z * axes[1][2];
+    const float hz = x * axes[2][0] + y * axes[2][1] + z * axes[2][2];
+    pThis->sourceX[emitter] = hx;
+    pThis->sourceY[emitter] = hy;
+    pThis->sourceZ[emitter] = hz;
+
+    const float horizontal = fastSqrt(hx * hx + hz * hz);
+    polar.sinAz = (horizontal > 1.0e-6f) ? hx / horizontal : 0.0f;
+    polar.elevN = (distance > 1.0e-6f) ? fastAsin(clampf(hy / distance, -1.0f, 1.0f)) * (2.0f / M_PI) : 0.0f;
+    polar.height = hy;
+}
+
+// Linear gain ramp endpoints for this block, from glideControls
+static void emitterGainRamp(const tinEarAlgorithm *pThis, int emitter, float &gainStart, float &gainEnd) {
+    gainStart = pThis->startGain[emitter];
+    gainEnd = pThis->currentGain[emitter];
+}
+
+// Busses are stride frames apart; busFrames may point into a block
+static const float *emitterInput(const tinEarAlgorithm *pThis, const float *busFrames,
+                                 int stride, int emitter) {
+    int inputBusIdx = kNumCommonParameters + kNumRoutingParameters + emitter * kNumPerEmitterParameters + kParamEmitterInput;
+    return busFrames + (pThis->v[inputBusIdx] - 1) * stride;
+}
+
+// Activity detection, after updateEmitterControl.  An emitter whose
+// input has stayed below kSilenceThreshold (or whose gain has sat at the
+// −60 dB floor) for idleTailSamples has decayed to silence and is
+// skipped; its state is left as it decayed, so rendering resumes on the
+// first loud block without a discontinuity.  Muted emitters may keep
+// some undecayed state, which is inaudible under the floor gain and is
+// flushed by the time the gain has glided up.
+static bool emitterActive(tinEarAlgorithm *pThis, int emitter, const float *in, int numFrames) {
+    bool quiet = pThis->targetAttenuation[emitter] <= kMuteFloorDb &&
+                 pThis->currentGain[emitter] == pThis->targetGain[emitter];
+    if (!quiet) {
+        quiet = true;
+        for (int n = 0; n < numFrames; ++n) {
+            if (fabsf(in[n]) >= kSilenceThreshold) {
+                quiet = false;
+                break;
+            }
         }
     }
 
-    // Process in chunks to handle arbitrary buffer sizes
-    constexpr int maxChunkSize = tinEarAlgorithm::MAX_BUFFER_SIZE;
+    if (!quiet) {
+        pThis->quietSamples[emitter] = 0;
+    } else if (pThis->quietSamples[emitter] >= pThis->idleTailSamples) {
+        return false;
+    } else {
+        pThis->quietSamples[emitter] += numFrames;
+    }
+    pThis->activeEmitters++;
+    return true;
+}
 
-    // Process each emitter
+// Level-of-detail scheduler for the per-emitter engine.  Active emitters
+// are ranked by audibility (input envelope × gain / distance); with the
+// budget in eighths of a full emitter, everyone is guaranteed the pan
+// tier and the rest of the budget upgrades emitters in rank order.  An
+// emitter mid-crossfade keeps its tiers and is charged the richer one.
+static void scheduleDetail(tinEarAlgorithm *pThis, const float *busFrames, int stride, int numFrames,
+                           const bool *active) {
+    const float release = 1.0f - numFrames * pThis->rate.invSampleRate * (1.0f / kDetailRelease);
+    int order[kMaxEmitters];
+    float score[kMaxEmitters];
+    int count = 0;
     for (int emitter = 0; emitter < pThis->numEmitters; ++emitter) {
-        // Apply slew limiting to smooth parameter changes for this emitter
-        pThis->currentAzimuth[emitter] = tinEarAlgorithm::slewLimit(
-            pThis->currentAzimuth[emitter], pThis->targetAzimuth[emitter],
-            tinEarAlgorithm::SLEW_RATE);
-
-        pThis->currentElevation[emitter] = tinEarAlgorithm::slewLimit(
-            pThis->currentElevation[emitter], pThis->targetElevation[emitter],
-            tinEarAlgorithm::SLEW_RATE);
-
-        pThis->currentDistance[emitter] = tinEarAlgorithm::slewLimit(
-            pThis->currentDistance[emitter], pThis->targetDistance[emitter],
-            tinEarAlgorithm::SLEW_RATE);
-            
-        pThis->currentAttenuation[emitter] = tinEarAlgorithm::slewLimit(
-            pThis->currentAttenuation[emitter], pThis->targetAttenuation[emitter],
-            tinEarAlgorithm::SLEW_RATE * 10.0f); // Faster slew for attenuation
+        if (!active[emitter])
+            continue;
+        const float *in = emitterInput(pThis, busFrames, stride, emitter);
+        float peak = pThis->levelEnvelope[emitter] * (release > 0.0f ? release : 0.0f);
+        for (int n = 0; n < numFrames; ++n) {
+            float a = fabsf(in[n]);
+            peak = (a > peak) ? a : peak;
+        }
+        pThis->levelEnvelope[emitter] = peak;
 
-        // Update source position based on smoothed angles
         const float distance = pThis->currentDistance[emitter];
-        pThis->sourceX[emitter] = distance * sinf(pThis->currentAzimuth[emitter]);
-        pThis->sourceZ[emitter] = distance * cosf(pThis->currentAzimuth[emitter]);
-        pThis->sourceY[emitter] = distance * sinf(pThis->currentElevation[emitter]);
-        
-        // Get input for this emitter
-        int inputBusIdx = kNumCommonParameters + kNumRoutingParameters + emitter * kNumPerEmitterParameters + kParamEmitterInput;
-        const float *input = busFrames + (pThis->v[inputBusIdx] - 1) * numFrames;
-        
-        // Calculate linear gain from dB attenuation
-        float linearGain = tinEarAlgorithm::dbToLinear(pThis->currentAttenuation[emitter]);
-
-        // Process audio for this emitter
-        for (int offset = 0; offset < numFrames; offset += maxChunkSize) {
-            int currentFrames = (numFrames - offset > maxChunkSize)
-                                    ? maxChunkSize
-                                    : (numFrames - offset);
-
-            // Apply spatial audio processing to this emitter's input
-            applyMonoSpatialAudio(input + offset, 
-                                  pThis->tempOutputL,
-                                  pThis->tempOutputR, 
-                                  currentFrames, 
-                                  pThis->sourceX[emitter],
-                                  pThis->sourceY[emitter], 
-                                  pThis->sourceZ[emitter],
-                                  &pThis->spatialStates[emitter]);
-
-            // Mix this emitter's output to the main output with attenuation
-            for (int i = 0; i < currentFrames; ++i) {
-                outL[offset + i] += pThis->tempOutputL[i] * linearGain;
-                outR[offset + i] += pThis->tempOutputR[i] * linearGain;
+        float s = peak * pThis->currentGain[emitter] / (distance > 0.1f ? distance : 0.1f);
+        for (int d = pThis->spatialStates[emitter].detail; d < kDetailPan; ++d)
+            s *= kDetailHold;
+
+        // Insertion sort, loudest first
+        int i = count++;
+        for (; i > 0 && score[i - 1] < s; --i) {
+            score[i] = score[i - 1];
+            order[i] = order[i - 1];
+        }
+        score[i] = s;
+        order[i] = emitter;
+    }
+
+    int remaining = pThis->v[kParamCpuBudget] * kDetailCost[kDetailFull] - count * kDetailCost[kDetailPan];
+    for (int i = 0; i < count; ++i) {
+        SpatialAudioState &st = pThis->spatialStates[order[i]];
+        SpatialDetail detail = kDetailPan;
+        if (remaining >= kDetailCost[kDetailFull] - kDetailCost[kDetailPan])
+            detail = kDetailFull;
+        else if (remaining >= kDetailCost[kDetailReduced] - kDetailCost[kDetailPan])
+            detail = kDetailReduced;
+
+        setSpatialDetail(&st, detail);
+        SpatialDetail charged = st.detail;
+        if (st.fadeRemaining > 0 && st.fadeFrom < charged)
+            charged = st.fadeFrom;
+        remaining -= kDetailCost[charged] - kDetailCost[kDetailPan];
+    }
+}
+
+// Adds an active emitter's dry input to the reverb send bus.  The send
+// follows the emitter's gain and grows with distance (reverbSendGain),
+// ramping from where the last block left it.
+static void reverbSendMix(tinEarAlgorithm *pThis, int emitter, const float *in, int numFrames) {
+    if (!pThis->reverbRunning)
+        return;
+    const float end = reverbSendGain(pThis->currentGain[emitter], pThis->currentDistance[emitter]);
+    const float step = (end - pThis->reverbSend[emitter]) / numFrames;
+    float g = pThis->reverbSend[emitter];
+    float *bus = pThis->reverbBus;
+    for (int n = 0; n < numFrames; ++n) {
+        g += step;
+        bus[n] += in[n] * g;
+    }
+    pThis->reverbSend[emitter] = end;
+}
+
+static float *speakerOutput(const tinEarAlgorithm *pThis, float *busFrames, int stride, int speaker) {
+    const int p = speakerParameterBase(pThis->numEmitters, pThis->cvEmitters) + speaker * kNumSpeakerParameters;
+    return busFrames + (pThis->v[p + kParamSpeakerOutput] - 1) * stride;
+}
+
+static bool renderingSpeakers(const tinEarAlgorithm *pThis) {
+    return pThis->renderMode == kRenderSpeakers && pThis->numSpeakers > 0;
+}
+
+// Runs the shared reverb over this block's send bus into the outputs,
+// which render() has already written.  The Speakers mode spreads the
+// stereo reverb over the array, left to odd-numbered speakers and right
+// to even, at equal total power.
+static void renderReverb(tinEarAlgorithm *pThis, float *busFrames, int stride, int numFrames) {
+    if (!pThis->reverbRunning)
+        return;
+    if (renderingSpeakers(pThis) && pThis->reverbStereo) {
+        float *wetL = pThis->reverbStereo;
+        float *wetR = pThis->reverbStereo + pThis->reverbBusFrames;
+        memset(wetL, 0, numFrames * sizeof(float));
+        memset(wetR, 0, numFrames * sizeof(float));
+        pThis->reverb.process(pThis->reverbBus, wetL, wetR, numFrames, pThis->reverbWet, pThis->reverbTarget);
+        pThis->reverbWet = pThis->reverbTarget;
+
+        const int count = pThis->numSpeakers;
+        const float spread = (count > 1) ? fastSqrt(2.0f / count) : 0.70710678f;
+        for (int s = 0; s < count; ++s) {
+            float *out = speakerOutput(pThis, busFrames, stride, s);
+            for (int n = 0; n < numFrames; ++n) {
+                const float wet = (count == 1) ? wetL[n] + wetR[n] : ((s & 1) ? wetR[n] : wetL[n]);
+                out[n] += wet * spread;
+            }
+        }
+        TINEAR_PROFILE_MARK(&pThis->profile, kStageRender);
+        return;
+    }
+    float *outL = busFrames + (pThis->v[kParamOutputL] - 1) * stride;
+    float *outR = busFrames + (pThis->v[kParamOutputR] - 1) * stride;
+    pThis->reverb.process(pThis->reverbBus, outL, outR, numFrames, pThis->reverbWet, pThis->reverbTarget);
+    pThis->reverbWet = pThis->reverbTarget;
+    TINEAR_PROFILE_MARK(&pThis->profile, kStageRender);
+}
+
+// Replace mode with every emitter idle: nothing overwrote the outputs
+static void clearIfUnwritten(float *outL, float *outR, int numFrames, bool overwrite) {
+    if (overwrite) {
+        memset(outL, 0, numFrames * sizeof(float));
+        memset(outR, 0, numFrames * sizeof(float));
+    }
+}
+
+// Ambisonic render mode.  The block is cut at partition boundaries:
+// each segment is encoded by every emitter, then the decoder emits the
+// matching output and runs the convolution when a partition completes.
+static void renderAmbisonic(tinEarAlgorithm *pThis, float *busFrames, int stride, int numFrames,
+                            float *outL, float *outR, bool overwrite) {
+    AmbiDecoder *decoder = pThis->ambiDecoder;
+    const int channels = decoder->channels;
+
+    float (*gainEnd)[kAmbiMaxChannels] = pThis->ambiTarget;
+    bool active[kMaxEmitters];
+    for (int emitter = 0; emitter < pThis->numEmitters; ++emitter) {
+        updateEmitterControl(pThis, emitter);
+        float gainStart, gain;
+        emitterGainRamp(pThis, emitter, gainStart, gain);
+        active[emitter] = emitterActive(pThis, emitter,
+                                        emitterInput(pThis, busFrames, stride, emitter), numFrames);
+        if (active[emitter])
+            reverbSendMix(pThis, emitter, emitterInput(pThis, busFrames, stride, emitter), numFrames);
+
+        // Engine axes (x left, y up, z front) → Ambisonic (x front, y left, z up)
+        float x = pThis->sourceX[emitter], y = pThis->sourceY[emitter], z = pThis->sourceZ[emitter];
+        float inv = 1.0f / fastSqrt(x * x + y * y + z * z + 1.0e-12f);
+        ambiEncodeGains(z * inv, x * inv, y * inv, decoder->order, gainEnd[emitter]);
+        for (int ch = 0; ch < channels; ++ch) {
+            gainEnd[emitter][ch] *= gain;
+        }
+    }
+    TINEAR_PROFILE_MARK(&pThis->profile, kStageControl);
+
+    for (int done = 0; done < numFrames; ) {
+        const int segment = ambiSegment(decoder, numFrames - done);
+        for (int emitter = 0; emitter < pThis->numEmitters; ++emitter) {
+            if (!active[emitter])
+                continue;
+            ambiEncodeMix(emitterInput(pThis, busFrames, stride, emitter) + done,
+                          segment, done, numFrames,
+                          pThis->ambiGains[emitter], gainEnd[emitter], decoder);
+        }
+        ambiDecodeMix(outL + done, outR + done, segment, overwrite, decoder, pThis->hrirRenderer);
+        done += segment;
+    }
+
+    for (int emitter = 0; emitter < pThis->numEmitters; ++emitter) {
+        memcpy(pThis->ambiGains[emitter], gainEnd[emitter], channels * sizeof(float));
+    }
+    TINEAR_PROFILE_MARK(&pThis->profile, kStageRender);
+}
+
+// Speakers render mode.  Every emitter's control, activity and reverb
+// send come first, so that Replace mode can clear the speaker busses
+// before anything is added to them; each active emitter then runs its
+// mono chain once and ramps it into every speaker with a gain.
+static void renderSpeakers(tinEarAlgorithm *pThis, float *busFrames, int stride, int numFrames,
+                           bool overwrite) {
+    const VbapLayout &layout = pThis->speakerLayout;
+    const int count = pThis->numSpeakers;
+    float *outs[kVbapMaxSpeakers];
+    for (int s = 0; s < count; ++s) {
+        outs[s] = speakerOutput(pThis, busFrames, stride, s);
+    }
+
+    float (*gainEnd)[kVbapMaxSpeakers] = pThis->speakerTarget;
+    bool active[kMaxEmitters];
+    for (int emitter = 0; emitter < pThis->numEmitters; ++emitter) {
+        updateEmitterControl(pThis, emitter);
+        float gainStart, gain;
+        emitterGainRamp(pThis, emitter, gainStart, gain);
+        const float *input = emitterInput(pThis, busFrames, stride, emitter);
+        active[emitter] = emitterActive(pThis, emitter, input, numFrames);
+        if (active[emitter])
+            reverbSendMix(pThis, emitter, input, numFrames);
+
+        layout.gains(pThis->sourceX[emitter], pThis->sourceY[emitter], pThis->sourceZ[emitter],
+                     pThis->vbapBase[emitter], gainEnd[emitter]);
+        for (int s = 0; s < count; ++s) {
+            gainEnd[emitter][s] *= gain;
+        }
+    }
+    if (overwrite) {
+        for (int s = 0; s < count; ++s) {
+            memset(outs[s], 0, numFrames * sizeof(float));
+        }
+    }
+    TINEAR_PROFILE_MARK(&pThis->profile, kStageControl);
+
+    for (int emitter = 0; emitter < pThis->numEmitters; ++emitter) {
+        if (!active[emitter])
+            continue;
+        TINEAR_PROFILE_BEGIN_EMITTER(&pThis->profile);
+        applyMonoSpeakerMix(emitterInput(pThis, busFrames, stride, emitter), outs, count, numFrames,
+                            pThis->sourceY[emitter], pThis->sourcePolar[emitter].dist,
+                            pThis->speakerGains[emitter], gainEnd[emitter],
+                            &pThis->spatialStates[emitter]);
+        TINEAR_PROFILE_END_EMITTERS(&pThis->profile, emitter, 1, kStageRender);
+    }
+
+    for (int emitter = 0; emitter < pThis->numEmitters; ++emitter) {
+        memcpy(pThis->speakerGains[emitter], gainEnd[emitter], count * sizeof(float));
+    }
+}
+
+// Head orientation for this block from the Listener page plus the MIDI
+// tracker: yaw turns the head left, pitch tilts it up, roll toward the
+// right ear, applied in that order.  Speakers are fixed in the room, so
+// the Speakers mode ignores it.
+static void updateListener(tinEarAlgorithm *pThis) {
+    const float yaw = pThis->v[kParamHeadYaw] * (M_PI / 180.0f) + pThis->headMidi[0];
+    const float pitch = pThis->v[kParamHeadPitch] * (M_PI / 180.0f) + pThis->headMidi[1];
+    const float roll = pThis->v[kParamHeadRoll] * (M_PI / 180.0f) + pThis->headMidi[2];
+    pThis->headRotated = (yaw != 0.0f || pitch != 0.0f || roll != 0.0f) && !renderingSpeakers(pThis);
+    if (!pThis->headRotated)
+        return;
+
+    const float sy = fastSin(yaw), cy = fastCos(yaw);
+    const float sp = fastSin(pitch), cp = fastCos(pitch);
+    const float sr = fastSin(roll), cr = fastCos(roll);
+    // Yaw about up, then pitch about the turned left axis, then roll
+    // about the resulting front axis
+    const float left[3] = { cy, 0.0f, -sy };
+    const float front1[3] = { sy, 0.0f, cy };
+    const float up2[3] = { -sp * front1[0], cp, -sp * front1[2] };
+    float (*axes)[3] = pThis->headAxes;
+    for (int k = 0; k < 3; ++k) {
+        axes[0][k] = cr * left[k] + sr * up2[k];
+        axes[1][k] = cr * up2[k] - sr * left[k];
+        axes[2][k] = cp * front1[k] + (k == 1 ? sp : 0.0f);
+    }
+}
+
+// Renders numFrames frames from busFrames, whose busses are stride frames apart
+static void render(tinEarAlgorithm *pThis, float *busFrames, int stride, int numFrames) {
+    if (NT_globals.sampleRate != pThis->sampleRate) {
+        applySampleRate(pThis, NT_globals.sampleRate);
+    }
+    glideControls(pThis, numFrames);
+    updateListener(pThis);
+
+    // Output channels
+    float *outL = busFrames + (pThis->v[kParamOutputL] - 1) * stride;
+    float *outR = busFrames + (pThis->v[kParamOutputR] - 1) * stride;
+
+    // Output mode (0 = Add, 1 = Replace).  In Replace mode the first
+    // emitter rendered overwrites the outputs instead of adding to them.
+    bool overwrite = pThis->v[kParamOutputMode];
+    pThis->activeEmitters = 0;
+
+    // Shared reverb: clear the send bus for the emitters to add into
+    pThis->reverbRunning = pThis->reverbBus && numFrames <= static_cast<int>(pThis->reverbBusFrames) &&
+                           (pThis->reverbTarget > 0.0f || pThis->reverbWet > 0.0f);
+    if (pThis->reverbRunning) {
+        memset(pThis->reverbBus, 0, numFrames * sizeof(float));
+    }
+
+    // Ambisonic bus: encode every emitter, decode once
+    if (pThis->renderMode == kRenderAmbisonic && pThis->ambiDecoder) {
+        renderAmbisonic(pThis, busFrames, stride, numFrames, outL, outR, overwrite);
+        return;
+    }
+
+    // Speaker array: VBAP instead of the binaural cues
+    if (renderingSpeakers(pThis) && pThis->spatialStates) {
+        renderSpeakers(pThis, busFrames, stride, numFrames, overwrite);
+        return;
+    }
+
+    // HRIR convolution, one emitter at a time
+    if (pThis->renderMode == kRenderHrir && pThis->hrirRenderer) {
+        for (int emitter = 0; emitter < pThis->numEmitters; ++emitter) {
+            updateEmitterControl(pThis, emitter);
+            float gainStart, gainEnd;
+            emitterGainRamp(pThis, emitter, gainStart, gainEnd);
+            const float *input = emitterInput(pThis, busFrames, stride, emitter);
+            if (!emitterActive(pThis, emitter, input, numFrames))
+                continue;
+            reverbSendMix(pThis, emitter, input, numFrames);
+            TINEAR_PROFILE_MARK(&pThis->profile, kStageControl);
+
+            TINEAR_PROFILE_BEGIN_EMITTER(&pThis->profile);
+            applyMonoHrirMix(input, outL, outR, numFrames,
+                             pThis->sourceX[emitter],
+                             pThis->sourceY[emitter],
+                             pThis->sourceZ[emitter],
+                             gainStart, gainEnd, overwrite,
+                             &pThis->spatialStates[emitter],
+                             &pThis->hrirStates[emitter],
+                             pThis->hrirRenderer);
+            TINEAR_PROFILE_END_EMITTERS(&pThis->profile, emitter, 1, kStageRender);
+            overwrite = false;
+        }
+        clearIfUnwritten(outL, outR, numFrames, overwrite);
+        return;
+    }
+
+    // Lane engine: kSpatialLanes emitters per call, mixed straight into the outputs
+    if (pThis->engine == kEngineLanes) {
+        for (int first = 0; first < pThis->numEmitters; first += kSpatialLanes) {
+            const int lanes = (pThis->numEmitters - first < kSpatialLanes)
+                                  ? (pThis->numEmitters - first)
+                                  : kSpatialLanes;
+
+            // Lanes own fixed filter state, so a group runs (idle lanes
+            // included) unless all of its emitters are idle
+            const float* inputs[kSpatialLanes] = {};
+            SpatialAudioState* states[kSpatialLanes] = {};
+            float gainStart[kSpatialLanes] = {};
+            float gainEnd[kSpatialLanes] = {};
+            bool anyActive = false;
+            for (int l = 0; l < lanes; ++l) {
+                const int emitter = first + l;
+                updateEmitterControl(pThis, emitter);
+                emitterGainRamp(pThis, emitter, gainStart[l], gainEnd[l]);
+                inputs[l] = emitterInput(pThis, busFrames, stride, emitter);
+                states[l] = &pThis->spatialStates[emitter];
+                if (emitterActive(pThis, emitter, inputs[l], numFrames)) {
+                    reverbSendMix(pThis, emitter, inputs[l], numFrames);
+                    anyActive = true;
+                }
             }
+            TINEAR_PROFILE_MARK(&pThis->profile, kStageControl);
+            if (!anyActive)
+                continue;
+
+            TINEAR_PROFILE_BEGIN_EMITTER(&pThis->profile);
+            applyMonoSpatialAudioLanes(inputs, outL, outR, numFrames, lanes,
+                                       pThis->sourceX + first,
+                                       pThis->sourceY + first,
+                                       pThis->sourceZ + first,
+                                       gainStart, gainEnd, overwrite, states,
+                                       &pThis->laneBanks[first / kSpatialLanes]);
+            TINEAR_PROFILE_END_EMITTERS(&pThis->profile, first, lanes, kStageRender);
+            overwrite = false;
+        }
+        clearIfUnwritten(outL, outR, numFrames, overwrite);
+        return;
+    }
+
+    // Per-emitter engine: control and activity first, so the scheduler
+    // can rank everyone before anything renders
+    bool active[kMaxEmitters];
+    float gainStart[kMaxEmitters], gainEnd[kMaxEmitters];
+    for (int emitter = 0; emitter < pThis->numEmitters; ++emitter) {
+        updateEmitterControl(pThis, emitter);
+        emitterGainRamp(pThis, emitter, gainStart[emitter], gainEnd[emitter]);
+        active[emitter] = emitterActive(pThis, emitter,
+                                        emitterInput(pThis, busFrames, stride, emitter), numFrames);
+        if (active[emitter])
+            reverbSendMix(pThis, emitter, emitterInput(pThis, busFrames, stride, emitter), numFrames);
+    }
+    scheduleDetail(pThis, busFrames, stride, numFrames, active);
+    TINEAR_PROFILE_MARK(&pThis->profile, kStageControl);
+
+    // Process each emitter, accumulating straight into the output busses
+    for (int emitter = 0; emitter < pThis->numEmitters; ++emitter) {
+        if (!active[emitter])
+            continue;
+
+        TINEAR_PROFILE_BEGIN_EMITTER(&pThis->profile);
+        applyMonoSpatialAudioPolar(emitterInput(pThis, busFrames, stride, emitter),
+                                   outL, outR, numFrames,
+                                   &pThis->sourcePolar[emitter],
+                                   gainStart[emitter], gainEnd[emitter], overwrite,
+                                   &pThis->spatialStates[emitter]);
+        TINEAR_PROFILE_END_EMITTERS(&pThis->profile, emitter, 1, kStageMix);
+        overwrite = false;
+    }
+    clearIfUnwritten(outL, outR, numFrames, overwrite);
+}
+
+// Reads each CV emitter's position CV at frame n of the block
+static void sampleEmitterCv(tinEarAlgorithm *pThis, const float *busFrames, int numFrames, int n) {
+    for (int emitter = 0; emitter < pThis->cvEmitters; ++emitter) {
+        const int16_t *bus = pThis->v + cvParameterBase(pThis->numEmitters) + emitter * kNumCvParameters;
+        float volts[kNumCvParameters];
+        for (int k = 0; k < kNumCvParameters; ++k) {
+            volts[k] = bus[k] ? clampf(busFrames[(bus[k] - 1) * numFrames + n], -kCvMaxVolts, kCvMaxVolts) : 0.0f;
+        }
+        pThis->cvAzimuth[emitter] = volts[kParamCvAzimuth] * kCvAzimuthPerVolt;
+        pThis->cvElevation[emitter] = volts[kParamCvElevation] * kCvElevationPerVolt;
+        pThis->cvDistance[emitter] = volts[kParamCvDistance] * (pThis->maxDistance / kCvMaxVolts);
+    }
+}
+
+void step(_NT_algorithm *self, float *busFrames, int numFramesBy4) {
+    auto *pThis = (tinEarAlgorithm *) self;
+    const int numFrames = numFramesBy4 * 4;
+
+    TINEAR_PROFILE_BEGIN_BLOCK(&pThis->profile);
+    if (!pThis->cvAssigned) {
+        render(pThis, busFrames, numFrames, numFrames);
+        renderReverb(pThis, busFrames, numFrames, numFrames);
+    } else {
+        // Decimated control path: each sub-block's positions come from
+        // the CV at its last frame, and the kernels ramp to them
+        const int interval = pThis->v[kParamCvInterval];
+        for (int done = 0; done < numFrames; done += interval) {
+            const int frames = (numFrames - done < interval) ? (numFrames - done) : interval;
+            sampleEmitterCv(pThis, busFrames, numFrames, done + frames - 1);
+            render(pThis, busFrames + done, numFrames, frames);
+            renderReverb(pThis, busFrames + done, numFrames, frames);
         }
     }
+    TINEAR_PROFILE_END_BLOCK(&pThis->profile, numFrames);
+}
+
+// Head tracker: 14-bit control change pairs on the Head MIDI channel.
+// An MSB alone moves by whole MSB steps, so 7-bit trackers work too.
+void midiMessage(_NT_algorithm *self, uint8_t byte0, uint8_t byte1, uint8_t byte2) {
+    auto *pThis = (tinEarAlgorithm *) self;
+    const int channel = pThis->v[kParamHeadMidi];
+    if (channel == 0 || byte0 != (0xb0 | (channel - 1)))
+        return;
+
+    int axis;
+    uint16_t raw;
+    if (byte1 >= kHeadMidiCcMsb && byte1 < kHeadMidiCcMsb + 3) {
+        axis = byte1 - kHeadMidiCcMsb;
+        raw = static_cast<uint16_t>(byte2 << 7);
+    } else if (byte1 >= kHeadMidiCcLsb && byte1 < kHeadMidiCcLsb + 3) {
+        axis = byte1 - kHeadMidiCcLsb;
+        raw = static_cast<uint16_t>((pThis->headMidiRaw[axis] & 0x3f80) | byte2);
+    } else {
+        return;
+    }
+    pThis->headMidiRaw[axis] = raw;
+    pThis->headMidi[axis] = (static_cast<int>(raw) - 8192) * kHeadMidiScale * (axis == 1 ? 0.5f : 1.0f);
+}
+
+#if TINEAR_PROFILE
+static_assert(kMaxEmitters <= kProfileMaxEmitters, "profile tracks every emitter");
+
+// Appends ticks as a percentage of the block's real-time budget, to
+// one decimal ("12.3")
+static int appendLoad(char *text, uint32_t ticks, uint64_t budget) {
+    int32_t tenths = budget ? static_cast<int32_t>(ticks * 1000ull / budget) : 0;
+    int len = NT_intToString(text, tenths / 10);
+    text[len++] = '.';
+    text[len++] = static_cast<char>('0' + tenths % 10);
+    text[len] = 0;
+    return len;
+}
+
+static int appendStat(char *text, const ProfileStat &stat, uint64_t budget) {
+    int len = appendLoad(text, stat.shownMin, budget);
+    text[len++] = ' ';
+    len += appendLoad(text + len, stat.shownAvg, budget);
+    text[len++] = ' ';
+    len += appendLoad(text + len, stat.shownMax, budget);
+    return len;
+}
+
+// Profiling builds replace the parameter display with the load meter:
+// total load, then min/avg/max per stage and for the heaviest emitter,
+// all in percent of the real-time budget over the last quarter second
+static void drawProfile(tinEarAlgorithm *pThis) {
+    static const char *const kStageNames[kNumProfileStages] = {
+        "Ctl", "Coef", "Dly", "Filt", "Mix", "Rndr",
+    };
+    const TinearProfile &profile = pThis->profile;
+    const uint64_t budget = static_cast<uint64_t>(profile.blockFrames.shownAvg) *
+                            TINEAR_PROFILE_HZ / pThis->sampleRate;
+    char text[48];
+
+    int len = 0;
+    memcpy(text, "Load ", 5);
+    len = 5 + appendLoad(text + 5, profile.block.shownAvg, budget);
+    memcpy(text + len, "% max ", 6);
+    len += 6;
+    len += appendLoad(text + len, profile.block.shownMax, budget);
+    text[len++] = '%';
+    text[len] = 0;
+    NT_drawText(0, 8, text, 15, kNT_textLeft, kNT_textTiny);
+
+    for (int s = 0; s < kNumProfileStages; ++s) {
+        const int y = 16 + 8 * s;
+        NT_drawText(0, y, kStageNames[s], 10, kNT_textLeft, kNT_textTiny);
+        appendStat(text, profile.stage[s], budget);
+        NT_drawText(24, y, text, 15, kNT_textLeft, kNT_textTiny);
+    }
+
+    int heaviest = 0;
+    for (int e = 1; e < pThis->numEmitters; ++e) {
+        if (profile.emitter[e].shownAvg > profile.emitter[heaviest].shownAvg)
+            heaviest = e;
+    }
+    memcpy(text, "Emitter ", 8);
+    len = 8 + NT_intToString(text + 8, heaviest + 1);
+    text[len] = 0;
+    NT_drawText(128, 16, text, 10, kNT_textLeft, kNT_textTiny);
+    appendStat(text, profile.emitter[heaviest], budget);
+    NT_drawText(128, 24, text, 15, kNT_textLeft, kNT_textTiny);
+}
+#endif
+
+// Active-emitter count in the title bar ("5/8"), above the standard
+// parameter display (or the load meter in profiling builds)
+bool draw(_NT_algorithm *self) {
+    tinEarAlgorithm *pThis = static_cast<tinEarAlgorithm *>(self);
+    char text[24];
+    int len = NT_intToString(text, pThis->activeEmitters);
+    text[len++] = '/';
+    NT_intToString(text + len, pThis->numEmitters);
+    NT_drawText(255, 8, text, 15, kNT_textRight, kNT_textTiny);
+#if TINEAR_PROFILE
+    drawProfile(pThis);
+    return true;
+#else
+    return false;
+#endif
 }
 
 static const _NT_specification specifications[] = {
     { .name = "Emitters", .min = 1, .max = kMaxEmitters, .def = 1, .type = kNT_typeGeneric },
+    { .name = "Coeff table", .min = 0, .max = SpatialCoeffTable::kMaxPoints, .def = 65, .type = kNT_typeGeneric },
+    { .name = "Head model", .min = 0, .max = kNumHrtfModels - 1, .def = 0, .type = kNT_typeGeneric },
+    { .name = "Ambi order", .min = 1, .max = kAmbiMaxOrder, .def = 1, .type = kNT_typeGeneric },
+    { .name = "Max distance", .min = 1, .max = 100, .def = 10, .type = kNT_typeGeneric },
+    { .name = "CV inputs", .min = 0, .max = kMaxCvEmitters, .def = 0, .type = kNT_typeGeneric },
+    { .name = "Speakers", .min = 0, .max = kVbapMaxSpeakers, .def = 0, .type = kNT_typeGeneric },
 };
 
 static const _NT_factory factory = {
@@ -411,15 +1725,15 @@ static const _NT_factory factory = {
     .description = "Spatial Audio Effect",
     .numSpecifications = ARRAY_SIZE(specifications),
     .specifications = specifications,
-    .calculateStaticRequirements = nullptr,
-    .initialise = nullptr,
+    .calculateStaticRequirements = calculateStaticRequirements,
+    .initialise = initialise,
     .calculateRequirements = calculateRequirements,
     .construct = construct,
     .parameterChanged = parameterChanged,
     .step = step,
-    .draw = nullptr,
+    .draw = draw,
     .midiRealtime = nullptr,
-    .midiMessage = nullptr,
+    .midiMessage = midiMessage,
     .tags = kNT_tagUtility,
     .hasCustomUi = nullptr,
     .customUi = nullptr,
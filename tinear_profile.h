@@ -0,0 +1,171 @@
+// Optional stage profiling (build with TINEAR_PROFILE=1)
+// -------------------------------------------------------------------
+// • Times step() by stage with the Cortex-M7 DWT cycle counter (or a
+//   nanosecond clock on host builds) and keeps rolling min/avg/max per
+//   stage, per emitter and per block, shown by the plugin's draw().
+// • Stages inside the fused parametric kernel are marked per sample, so
+//   a profiling build runs a few percent slower than the one it
+//   measures; on the host the clock reads dominate the per-sample
+//   stages and only the block and per-emitter totals are meaningful.
+//   The two-pass kernel is marked per pass: its control pass counts as
+//   coefficients and its audio pass (delay, filter, mix) as filter.
+// • Without TINEAR_PROFILE the macros expand to nothing and no state
+//   is added anywhere.
+
+#pragma once
+
+#include <cstdint>
+
+enum ProfileStage : uint8_t {
+    kStageControl,       // glides, position conversion, LOD scheduling
+    kStageCoeffs,        // shelf / notch / air coefficient updates
+    kStageDelay,         // history write, ITD and reflection taps
+    kStageFilter,        // air, ILD, shelf, notch, tier crossfade
+    kStageMix,           // gain ramp and bus write
+    kStageRender,        // lanes / HRIR / Ambisonic kernels (not split)
+    kNumProfileStages,
+};
+
+#ifndef TINEAR_PROFILE
+#define TINEAR_PROFILE 0
+#endif
+
+#if TINEAR_PROFILE
+
+#if defined(__ARM_ARCH)
+// DWT cycle counter; ticks are CPU cycles
+#ifndef TINEAR_PROFILE_HZ
+#define TINEAR_PROFILE_HZ 600000000u
+#endif
+
+static inline uint32_t profileNow()
+{
+    return *reinterpret_cast<volatile uint32_t*>(0xE0001004u);      // DWT_CYCCNT
+}
+
+static inline void profileEnable()
+{
+    *reinterpret_cast<volatile uint32_t*>(0xE000EDFCu) |= 1u << 24;  // DEMCR.TRCENA
+    *reinterpret_cast<volatile uint32_t*>(0xE0001FB0u) = 0xC5ACCE55u; // DWT_LAR unlock (M7)
+    *reinterpret_cast<volatile uint32_t*>(0xE0001000u) |= 1u;        // DWT_CTRL.CYCCNTENA
+}
+#else
+// Host: steady clock; ticks are nanoseconds
+#include <chrono>
+
+#define TINEAR_PROFILE_HZ 1000000000u
+
+static inline uint32_t profileNow()
+{
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static inline void profileEnable() {}
+#endif
+
+// Ticks per block: min/avg/max over the current window, and the
+// last completed window for display
+struct ProfileStat {
+    uint32_t min = UINT32_MAX, max = 0, count = 0;
+    uint64_t sum = 0;
+    uint32_t shownMin = 0, shownAvg = 0, shownMax = 0;
+
+    void add(uint32_t ticks)
+    {
+        min = (ticks < min) ? ticks : min;
+        max = (ticks > max) ? ticks : max;
+        sum += ticks;
+        ++count;
+    }
+
+    void roll()
+    {
+        if (count) {
+            shownMin = min;
+            shownAvg = static_cast<uint32_t>(sum / count);
+            shownMax = max;
+        }
+        *this = ProfileStat{ UINT32_MAX, 0, 0, 0, shownMin, shownAvg, shownMax };
+    }
+};
+
+constexpr int kProfileMaxEmitters = 32;
+
+struct TinearProfile {
+    ProfileStat stage[kNumProfileStages];
+    ProfileStat emitter[kProfileMaxEmitters];
+    ProfileStat block;                       // all of step()
+    ProfileStat blockFrames;                 // frames per block, to scale the load
+
+    // This block's per-stage accumulators and the last mark
+    uint32_t stageTicks[kNumProfileStages] = {};
+    uint32_t mark = 0;
+    uint32_t blockStart = 0;
+    uint32_t emitterStart = 0;
+
+    // Statistics roll over every windowFrames (≈0.25 s)
+    uint32_t windowFrames = 12000;
+    uint32_t framesInWindow = 0;
+
+    void beginBlock()
+    {
+        for (uint32_t& t : stageTicks)
+            t = 0;
+        blockStart = mark = profileNow();
+    }
+
+    void endBlock(int numFrames)
+    {
+        block.add(profileNow() - blockStart);
+        blockFrames.add(static_cast<uint32_t>(numFrames));
+        for (int s = 0; s < kNumProfileStages; ++s)
+            stage[s].add(stageTicks[s]);
+
+        framesInWindow += numFrames;
+        if (framesInWindow >= windowFrames) {
+            framesInWindow = 0;
+            for (ProfileStat& s : stage)   s.roll();
+            for (ProfileStat& e : emitter) e.roll();
+            block.roll();
+            blockFrames.roll();
+        }
+    }
+
+    // Charges the time since the last mark to stage s
+    void markStage(ProfileStage s)
+    {
+        uint32_t now = profileNow();
+        stageTicks[s] += now - mark;
+        mark = now;
+    }
+
+    // Render time of emitters first…first + count − 1 (a lane group is
+    // shared equally), charged to stage s
+    void beginEmitter() { emitterStart = mark = profileNow(); }
+    void endEmitters(int first, int count, ProfileStage s)
+    {
+        markStage(s);
+        uint32_t each = (mark - emitterStart) / static_cast<uint32_t>(count);
+        for (int e = first; e < first + count; ++e)
+            emitter[e].add(each);
+    }
+};
+
+#define TINEAR_PROFILE_MARK(profile, stage) \
+    do { if (profile) (profile)->markStage(stage); } while (0)
+#define TINEAR_PROFILE_BEGIN_BLOCK(profile)            (profile)->beginBlock()
+#define TINEAR_PROFILE_END_BLOCK(profile, frames)      (profile)->endBlock(frames)
+#define TINEAR_PROFILE_BEGIN_EMITTER(profile)          (profile)->beginEmitter()
+#define TINEAR_PROFILE_END_EMITTERS(profile, first, count, stage) \
+    (profile)->endEmitters(first, count, stage)
+
+#else
+
+#define TINEAR_PROFILE_MARK(profile, stage)                       do {} while (0)
+#define TINEAR_PROFILE_BEGIN_BLOCK(profile)                       do {} while (0)
+#define TINEAR_PROFILE_END_BLOCK(profile, frames)                 do {} while (0)
+#define TINEAR_PROFILE_BEGIN_EMITTER(profile)                     do {} while (0)
+#define TINEAR_PROFILE_END_EMITTERS(profile, first, count, stage) do {} while (0)
+
+#endif
@@ -0,0 +1,307 @@
+// Tin Ear HRTF dataset converter
+// -------------------------------------------------------------------
+// • Produces TEHR blobs (hrtf_dataset.h) from a SOFA file or from the
+//   built-in spherical-head model, resampled onto a ring grid.
+// • Each grid point takes the nearest measurement on the sphere.  Its
+//   magnitude response is interpolated onto the output sample rate's
+//   frequency grid and rebuilt as minimum phase; the ITD comes from the
+//   measured onset difference between the ears.
+// • SOFA input needs libmysofa (make hrtf-convert MYSOFA=1).
+//
+//   build/host/hrtf_convert (--sofa FILE | --model spherical) [-o OUT.tehr]
+//                           [--header OUT.h] [--name NAME]
+//                           [--rings MIN:MAX:STEP] [--azimuths N]
+//                           [--length N] [--rate HZ]
+//                           [--format int16|float16] [--asymmetric]
+//   build/host/hrtf_convert --info FILE.tehr
+
+#include "hrtf_dataset.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(HAVE_MYSOFA)
+#include <mysofa.h>
+#endif
+
+namespace {
+
+// ────────────────────────────────────────────────────────────────
+// SOFA source
+// ────────────────────────────────────────────────────────────────
+#if defined(HAVE_MYSOFA)
+struct SofaSource {
+    MYSOFA_HRTF* hrtf    = nullptr;
+    float        srcRate = 0.0f;
+    float        outRate = kSampleRate;
+    RealFft      fft;
+    int          fftSize = 0;
+    std::vector<float> frame, re, im;
+
+    ~SofaSource() { if (hrtf) mysofa_free(hrtf); }
+
+    bool load(const char* path) {
+        int err = 0;
+        hrtf = mysofa_load(path, &err);
+        if (!hrtf || err != MYSOFA_OK) {
+            fprintf(stderr, "%s: cannot read SOFA file (error %d)\n", path, err);
+            return false;
+        }
+        if (hrtf->R != 2) {
+            fprintf(stderr, "%s: expected 2 receivers, found %u\n", path, hrtf->R);
+            return false;
+        }
+        mysofa_tospherical(hrtf);       // SourcePosition → az°, el°, r
+        srcRate = hrtf->DataSamplingRate.values[0];
+
+        fftSize = 8;
+        while (fftSize < static_cast<int>(hrtf->N) && fftSize < RealFft::kMaxSize)
+            fftSize <<= 1;
+        fft.init(fftSize);
+        frame.resize(fftSize);
+        re.resize(fftSize / 2 + 1);
+        im.resize(fftSize / 2 + 1);
+        return true;
+    }
+
+    int nearestMeasurement(float azDeg, float elDeg) const {
+        const float az = azDeg * (M_PI / 180.0f), el = elDeg * (M_PI / 180.0f);
+        const float x = cosf(el) * cosf(az), y = cosf(el) * sinf(az), z = sinf(el);
+        int   best = 0;
+        float bestDot = -2.0f;
+        for (unsigned m = 0; m < hrtf->M; ++m) {
+            const float* p  = hrtf->SourcePosition.values + m * 3;
+            const float  ma = p[0] * (M_PI / 180.0f), me = p[1] * (M_PI / 180.0f);
+            const float  d  = x * cosf(me) * cosf(ma) + y * cosf(me) * sinf(ma) + z * sinf(me);
+            if (d > bestDot) { bestDot = d; best = static_cast<int>(m); }
+        }
+        return best;
+    }
+
+    const float* ir(int m, int ear) const {
+        return hrtf->DataIR.values + (m * hrtf->R + ear) * hrtf->N;
+    }
+
+    void magnitude(float azDeg, float elDeg, int ear, float* mag) {
+        const float* h = ir(nearestMeasurement(azDeg, elDeg), ear);
+        const int    n = std::min<int>(hrtf->N, fftSize);
+        std::fill(frame.begin(), frame.end(), 0.0f);
+        std::copy(h, h + n, frame.begin());
+        fft.forward(frame.data(), re.data(), im.data());
+
+        // Linear interpolation onto the output grid; held above the
+        // source Nyquist
+        const int   srcBins = fftSize / 2 + 1;
+        const float binHz   = srcRate / fftSize;
+        for (int k = 0; k < kHrtfBuildBins; ++k) {
+            float pos = k * outRate / kHrtfBuildFft / binHz;
+            int   i   = std::min(static_cast<int>(pos), srcBins - 1);
+            int   j   = std::min(i + 1, srcBins - 1);
+            float t   = std::min(pos - i, 1.0f);
+            float a   = hypotf(re[i], im[i]), b = hypotf(re[j], im[j]);
+            mag[k]    = a + t * (b - a);
+        }
+    }
+
+    // First crossing of −20 dB re. peak, linearly interpolated
+    float onset(const float* h) const {
+        float peak = 0.0f;
+        for (unsigned n = 0; n < hrtf->N; ++n)
+            peak = std::max(peak, fabsf(h[n]));
+        const float thr = 0.1f * peak;
+        for (unsigned n = 0; n < hrtf->N; ++n) {
+            if (fabsf(h[n]) >= thr) {
+                if (n == 0) return 0.0f;
+                float a = fabsf(h[n - 1]), b = fabsf(h[n]);
+                return n - 1 + (thr - a) / (b - a);
+            }
+        }
+        return 0.0f;
+    }
+
+    float itd(float azDeg, float elDeg) {
+        const int m = nearestMeasurement(azDeg, elDeg);
+        return (onset(ir(m, 1)) - onset(ir(m, 0))) * (outRate / srcRate);
+    }
+
+    static void magnitudeFn(void* c, float az, float el, int ear, float* mag) {
+        static_cast<SofaSource*>(c)->magnitude(az, el, ear, mag);
+    }
+    static float itdFn(void* c, float az, float el) {
+        return static_cast<SofaSource*>(c)->itd(az, el);
+    }
+};
+#endif
+
+// ────────────────────────────────────────────────────────────────
+// Output
+// ────────────────────────────────────────────────────────────────
+bool writeBinary(const std::string& path, const std::vector<uint32_t>& blob, uint32_t bytes)
+{
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = fwrite(blob.data(), 1, bytes, f) == bytes;
+    return fclose(f) == 0 && ok;
+}
+
+bool writeHeader(const std::string& path, const std::string& symbol,
+                 const std::vector<uint32_t>& blob, uint32_t bytes)
+{
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) return false;
+    fprintf(f, "// Generated by tools/hrtf_convert – TEHR blob, see hrtf_dataset.h\n\n"
+               "#pragma once\n\n#include <cstdint>\n\n"
+               "alignas(4) static const uint8_t %s[%u] = {", symbol.c_str(), bytes);
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(blob.data());
+    for (uint32_t i = 0; i < bytes; ++i)
+        fprintf(f, "%s0x%02x,", (i % 16) ? " " : "\n    ", p[i]);
+    fprintf(f, "\n};\n");
+    return fclose(f) == 0;
+}
+
+int printInfo(const char* path)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) { fprintf(stderr, "cannot open %s\n", path); return 1; }
+    std::vector<uint32_t> blob;
+    uint32_t bytes = 0;
+    for (;;) {
+        blob.resize(blob.size() + 4096);
+        size_t got = fread(reinterpret_cast<uint8_t*>(blob.data()) + bytes, 1, 4096 * 4, f);
+        bytes += static_cast<uint32_t>(got);
+        if (got < 4096 * 4) break;
+    }
+    fclose(f);
+
+    HrtfDataset ds;
+    if (!ds.bind(blob.data(), bytes)) {
+        fprintf(stderr, "%s: not a valid TEHR v%u blob\n", path, kHrtfVersion);
+        return 1;
+    }
+    const HrtfHeader* h = reinterpret_cast<const HrtfHeader*>(blob.data());
+    printf("%s: \"%s\", %u bytes, %u Hz, %s, %d taps, %s\n", path, ds.name(), h->totalBytes,
+           h->sampleRate, h->format == kHrtfFloat16 ? "float16" : "int16", ds.irLength(),
+           (h->flags & kHrtfFlagSymmetric) ? "symmetric" : "two-ear");
+    printf("%d points on %d rings:", ds.numPoints(), ds.numRings());
+    for (int r = 0; r < ds.numRings(); ++r)
+        printf(" %g°×%d", ds.ring(r).elevation, ds.ring(r).numAz);
+    printf("\nmax ITD %.2f samples\n", ds.itd(90.0f, 0.0f));
+    return 0;
+}
+
+void usage(const char* argv0)
+{
+    fprintf(stderr,
+            "usage: %s (--sofa FILE | --model spherical) [-o OUT.tehr] [--header OUT.h]\n"
+            "          [--symbol NAME] [--name NAME] [--rings MIN:MAX:STEP] [--azimuths N]\n"
+            "          [--length N] [--rate HZ] [--format int16|float16] [--asymmetric]\n"
+            "       %s --info FILE.tehr\n", argv0, argv0);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string sofaPath, model, outPath, headerPath, symbol, name;
+    float elevMin = -40.0f, elevMax = 80.0f, elevStep = 10.0f;
+    int   horizAz = 48;
+    HrtfWriteOptions opts;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) { usage(argv[0]); exit(2); }
+            return argv[++i];
+        };
+        if (a == "--info")               return printInfo(next());
+        else if (a == "--sofa")          sofaPath = next();
+        else if (a == "--model")         model = next();
+        else if (a == "-o")              outPath = next();
+        else if (a == "--header")        headerPath = next();
+        else if (a == "--symbol")        symbol = next();
+        else if (a == "--name")          name = next();
+        else if (a == "--azimuths")      horizAz = atoi(next());
+        else if (a == "--length")        opts.irLength = atoi(next());
+        else if (a == "--rate")          opts.sampleRate = static_cast<uint32_t>(atoi(next()));
+        else if (a == "--asymmetric")    opts.symmetric = false;
+        else if (a == "--format") {
+            std::string f = next();
+            if (f == "int16")        opts.format = kHrtfInt16;
+            else if (f == "float16") opts.format = kHrtfFloat16;
+            else { usage(argv[0]); return 2; }
+        }
+        else if (a == "--rings") {
+            if (sscanf(next(), "%f:%f:%f", &elevMin, &elevMax, &elevStep) != 3 || elevStep < 1.0f) {
+                usage(argv[0]);
+                return 2;
+            }
+        }
+        else { usage(argv[0]); return 2; }
+    }
+    if (sofaPath.empty() == model.empty() || (outPath.empty() && headerPath.empty())) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (opts.irLength < 16 || opts.irLength > kHrtfMaxIrLength) {
+        fprintf(stderr, "--length must be 16…%d\n", kHrtfMaxIrLength);
+        return 2;
+    }
+    if (name.empty())
+        name = model.empty() ? sofaPath.substr(sofaPath.find_last_of('/') + 1) : model;
+    name = name.substr(0, sizeof(HrtfHeader::name) - 1);
+    if (symbol.empty())
+        symbol = "kHrtf" + name;
+    for (char& c : symbol)
+        if (!isalnum(static_cast<unsigned char>(c))) c = '_';
+    opts.name = name.c_str();
+
+    HrtfGrid grid;
+    grid.rings(elevMin, elevMax, elevStep, horizAz);
+    if (grid.numPoints() > 65535) {
+        fprintf(stderr, "grid too dense (%d points)\n", grid.numPoints());
+        return 2;
+    }
+
+    float      rate = static_cast<float>(opts.sampleRate);
+    HrtfSource source;
+#if defined(HAVE_MYSOFA)
+    SofaSource sofa;
+#endif
+    if (model == "spherical") {
+        source = sphericalHeadSource(&rate);
+    } else if (!model.empty()) {
+        fprintf(stderr, "unknown model '%s'\n", model.c_str());
+        return 2;
+    } else {
+#if defined(HAVE_MYSOFA)
+        if (!sofa.load(sofaPath.c_str()))
+            return 1;
+        sofa.outRate     = rate;
+        source.context   = &sofa;
+        source.magnitude = SofaSource::magnitudeFn;
+        source.itd       = SofaSource::itdFn;
+#else
+        fprintf(stderr, "SOFA input needs libmysofa: rebuild with make hrtf-convert MYSOFA=1\n");
+        return 2;
+#endif
+    }
+
+    static HrtfBuildScratch scratch;
+    std::vector<uint32_t>   blob(hrtfBlobBytes(grid, opts) / 4);
+    uint32_t bytes = hrtfWriteBlob(blob.data(), grid, opts, source, scratch);
+
+    if (!outPath.empty() && !writeBinary(outPath, blob, bytes)) {
+        fprintf(stderr, "cannot write %s\n", outPath.c_str());
+        return 1;
+    }
+    if (!headerPath.empty() && !writeHeader(headerPath, symbol, blob, bytes)) {
+        fprintf(stderr, "cannot write %s\n", headerPath.c_str());
+        return 1;
+    }
+    printf("%s: %d points, %d taps, %u bytes\n", name.c_str(), grid.numPoints(), opts.irLength, bytes);
+    return 0;
+}
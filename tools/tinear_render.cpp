@@ -0,0 +1,1088 @@
+// Tin Ear offline renderer
+// -------------------------------------------------------------------
+// • Renders mono WAV stems to a binaural WAV through the plugin itself:
+//   factory, parameterChanged and step() driven exactly as the module
+//   would, one fixed-size block at a time, with each emitter's position
+//   taken from a trajectory file at every block boundary.
+// • Stems stream through in bounded chunks.  A thread pool runs jobs
+//   (output files) in parallel and, inside a job, one plugin instance
+//   per emitter; each chunk's emitter outputs are then summed in
+//   emitter order, which is the order step() accumulates them in.
+// • Output is bit-identical to one plugin instance rendering every
+//   emitter at the same block size (--check renders both ways and
+//   compares), except that −0 is written as +0.  Scenes whose emitters
+//   interact – Lanes engine, Ambisonic mode, Auto Spread, a CPU budget
+//   below the emitter count, the shared reverb – render as that single instance instead,
+//   and parallelise across files only.
+// • --golden renders a fixed set of synthetic scenes and compares their
+//   output hashes with a checked-in list: a regression base for DSP
+//   changes that should not change the output.  Hashes are specific to
+//   the host toolchain; --update rewrites the list after an intended
+//   change.  It also checks that step jumps render alike at 8, 32 and
+//   128 frames per block.
+//
+//   build/host/tinear_render [options] -o OUT.wav [-t TRAJECTORY] STEM.wav…
+//   build/host/tinear_render [options] --batch JOBS.txt
+//   build/host/tinear_render [options] --golden LIST [--update]
+//
+//   options: [--block N] [--chunk N] [--threads N] [--tail S]
+//            [--format f32|s16|s24] [--full-scale V]
+//            [--spec NAME=VALUE] [--param NAME=VALUE] [--hash] [--check]
+//
+// Trajectory files have one key per line, keys interpolated linearly
+// per emitter and held before the first and after the last:
+//
+//   # seconds  emitter  azimuth°  elevation°  distance(m)  [gain dB]
+//   0.0        1        -90       0           2.0
+//   8.0        1        270       30          1.0          -6
+//
+// Azimuth wraps to ±180° after interpolation, so keys may run past it
+// for continuous orbits.  Positions are rounded to the parameters'
+// resolution (1°, 0.1 m, 1 dB) and glided by the plugin as usual.
+//
+// A batch file lists one job per line: OUT.wav TRAJECTORY|- STEM.wav…
+
+#include "nt_host.h"
+#include "fast_math.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace {
+
+// Busses 1–26 carry emitter inputs, 27/28 the binaural output
+constexpr int kOutputBusL = 27;
+constexpr int kOutputBusR = 28;
+constexpr int kMaxCombinedEmitters = kOutputBusL - 1;
+
+struct RenderOptions {
+    int         block      = 32;       // frames per step(), multiple of 4
+    int         chunk      = 8192;     // frames streamed per pass
+    int         threads    = 0;        // 0 = hardware concurrency
+    double      tail       = 1.0;      // s rendered after the longest stem
+    int         format     = 0;        // 0 f32, 1 s16, 2 s24
+    float       fullScale  = 10.0f;    // volts at WAV full scale
+    bool        hash       = false;
+    bool        check      = false;
+    std::vector<std::pair<std::string, int>> specOverrides, paramOverrides;
+};
+
+// ────────────────────────────────────────────────────────────────
+// WAV streaming
+// ────────────────────────────────────────────────────────────────
+static uint32_t readLe(const uint8_t* p, int bytes)
+{
+    uint32_t v = 0;
+    for (int i = bytes - 1; i >= 0; --i)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+static void writeLe(FILE* f, uint32_t v, int bytes)
+{
+    for (int i = 0; i < bytes; ++i)
+        fputc(static_cast<int>((v >> (8 * i)) & 0xff), f);
+}
+
+// Mono PCM 16/24/32-bit or float 32-bit, read a chunk at a time
+struct WavReader {
+    FILE*    file     = nullptr;
+    uint32_t rate     = 0;
+    int      bits     = 0;
+    bool     isFloat  = false;
+    int64_t  frames   = 0;
+    int64_t  position = 0;
+    std::vector<uint8_t> raw;
+
+    ~WavReader() { if (file) fclose(file); }
+
+    bool open(const std::string& path) {
+        file = fopen(path.c_str(), "rb");
+        if (!file) {
+            fprintf(stderr, "%s: cannot open\n", path.c_str());
+            return false;
+        }
+        uint8_t header[12];
+        if (fread(header, 1, 12, file) != 12 || memcmp(header, "RIFF", 4) || memcmp(header + 8, "WAVE", 4)) {
+            fprintf(stderr, "%s: not a RIFF/WAVE file\n", path.c_str());
+            return false;
+        }
+        int channels = 0;
+        for (;;) {
+            uint8_t chunk[8];
+            if (fread(chunk, 1, 8, file) != 8) {
+                fprintf(stderr, "%s: no data chunk\n", path.c_str());
+                return false;
+            }
+            uint32_t size = readLe(chunk + 4, 4);
+            if (!memcmp(chunk, "fmt ", 4)) {
+                uint8_t fmt[40] = {};
+                uint32_t n = std::min<uint32_t>(size, sizeof(fmt));
+                if (fread(fmt, 1, n, file) != n)
+                    return false;
+                fseek(file, (size - n) + (size & 1), SEEK_CUR);
+                uint32_t tag = readLe(fmt, 2);
+                if (tag == 0xfffe && size >= 26)
+                    tag = readLe(fmt + 24, 2);      // WAVE_FORMAT_EXTENSIBLE sub-format
+                channels = static_cast<int>(readLe(fmt + 2, 2));
+                rate     = readLe(fmt + 4, 4);
+                bits     = static_cast<int>(readLe(fmt + 14, 2));
+                isFloat  = tag == 3;
+                if ((tag != 1 && tag != 3) || (isFloat && bits != 32) ||
+                    (!isFloat && bits != 16 && bits != 24 && bits != 32)) {
+                    fprintf(stderr, "%s: unsupported sample format (tag %u, %d bits)\n", path.c_str(), tag, bits);
+                    return false;
+                }
+            } else if (!memcmp(chunk, "data", 4)) {
+                if (channels != 1) {
+                    fprintf(stderr, "%s: stems must be mono (%d channels)\n", path.c_str(), channels);
+                    return false;
+                }
+                frames = size / (bits / 8);
+                return true;
+            } else {
+                fseek(file, size + (size & 1), SEEK_CUR);
+            }
+        }
+    }
+
+    // Fills count samples; zeros past the end of the data
+    void read(float* out, int count) {
+        int64_t avail = std::max<int64_t>(0, std::min<int64_t>(count, frames - position));
+        const int bytes = bits / 8;
+        raw.resize(static_cast<size_t>(avail) * bytes);
+        avail = static_cast<int64_t>(fread(raw.data(), bytes, static_cast<size_t>(avail), file));
+        for (int64_t n = 0; n < avail; ++n) {
+            const uint8_t* p = raw.data() + n * bytes;
+            if (isFloat) {
+                memcpy(&out[n], p, 4);
+            } else {
+                int32_t s = static_cast<int32_t>(readLe(p, bytes) << (32 - bits));
+                out[n] = static_cast<float>(s) * (1.0f / 2147483648.0f);
+            }
+        }
+        std::fill(out + avail, out + count, 0.0f);
+        position += count;
+    }
+};
+
+// Stereo float 32-bit or PCM 16/24-bit; sizes are patched on close
+struct WavWriter {
+    FILE*   file   = nullptr;
+    int     format = 0;
+    int64_t frames = 0;
+
+    ~WavWriter() { close(); }
+
+    int bytesPerSample() const { return format == 0 ? 4 : format == 1 ? 2 : 3; }
+
+    bool open(const std::string& path, uint32_t rate, int format_) {
+        format = format_;
+        file = fopen(path.c_str(), "wb");
+        if (!file) {
+            fprintf(stderr, "%s: cannot write\n", path.c_str());
+            return false;
+        }
+        const int bytes = bytesPerSample();
+        fwrite("RIFF", 1, 4, file); writeLe(file, 0, 4); fwrite("WAVEfmt ", 1, 8, file);
+        writeLe(file, 16, 4);
+        writeLe(file, format == 0 ? 3 : 1, 2);
+        writeLe(file, 2, 2);
+        writeLe(file, rate, 4);
+        writeLe(file, rate * 2 * bytes, 4);
+        writeLe(file, 2 * bytes, 2);
+        writeLe(file, 8 * bytes, 2);
+        fwrite("data", 1, 4, file); writeLe(file, 0, 4);
+        return true;
+    }
+
+    void write(const float* left, const float* right, int count, float invScale) {
+        for (int n = 0; n < count; ++n) {
+            for (float x : { left[n] * invScale, right[n] * invScale }) {
+                if (format == 0) {
+                    uint32_t bits;
+                    memcpy(&bits, &x, 4);
+                    writeLe(file, bits, 4);
+                } else {
+                    const float peak = format == 1 ? 32767.0f : 8388607.0f;
+                    float s = std::max(-1.0f, std::min(1.0f, x)) * peak;
+                    writeLe(file, static_cast<uint32_t>(static_cast<int32_t>(lrintf(s))), bytesPerSample());
+                }
+            }
+        }
+        frames += count;
+    }
+
+    void close() {
+        if (!file)
+            return;
+        uint32_t data = static_cast<uint32_t>(frames * 2 * bytesPerSample());
+        fseek(file, 4, SEEK_SET);  writeLe(file, 36 + data, 4);
+        fseek(file, 40, SEEK_SET); writeLe(file, data, 4);
+        fclose(file);
+        file = nullptr;
+    }
+};
+
+// ────────────────────────────────────────────────────────────────
+// Trajectories
+// ────────────────────────────────────────────────────────────────
+struct Key {
+    double t;
+    float  azimuth, elevation, distance, gain;
+};
+
+struct Trajectory {
+    std::vector<std::vector<Key>> emitters;    // sorted by time
+
+    bool load(const std::string& path, int numEmitters) {
+        emitters.assign(numEmitters, {});
+        if (path.empty() || path == "-")
+            return true;
+        FILE* f = fopen(path.c_str(), "r");
+        if (!f) {
+            fprintf(stderr, "%s: cannot open\n", path.c_str());
+            return false;
+        }
+        char line[256];
+        int  lineNo = 0;
+        bool ok = true;
+        while (ok && fgets(line, sizeof(line), f)) {
+            ++lineNo;
+            char* hash = strchr(line, '#');
+            if (hash)
+                *hash = 0;
+            Key   k{ 0.0, 0.0f, 0.0f, 1.0f, 0.0f };
+            int   emitter = 0;
+            int   n = sscanf(line, "%lf %d %f %f %f %f", &k.t, &emitter, &k.azimuth, &k.elevation,
+                             &k.distance, &k.gain);
+            if (n <= 0)
+                continue;
+            if (n < 5 || emitter < 1) {
+                fprintf(stderr, "%s:%d: expected seconds emitter azimuth elevation distance [gain]\n",
+                        path.c_str(), lineNo);
+                ok = false;
+            } else if (emitter <= numEmitters) {
+                emitters[emitter - 1].push_back(k);
+            }
+        }
+        fclose(f);
+        for (auto& keys : emitters)
+            std::stable_sort(keys.begin(), keys.end(), [](const Key& a, const Key& b) { return a.t < b.t; });
+        return ok;
+    }
+
+    // Position at time t; the plugin defaults with no keys
+    Key at(int emitter, double t) const {
+        const std::vector<Key>& keys = emitters[emitter];
+        if (keys.empty())
+            return { t, 0.0f, 0.0f, 1.0f, 0.0f };
+        if (t <= keys.front().t)
+            return keys.front();
+        if (t >= keys.back().t)
+            return keys.back();
+        auto hi = std::upper_bound(keys.begin(), keys.end(), t,
+                                   [](double v, const Key& k) { return v < k.t; });
+        const Key& a = hi[-1];
+        const Key& b = hi[0];
+        const float u = static_cast<float>((t - a.t) / (b.t - a.t));
+        return { t, a.azimuth + (b.azimuth - a.azimuth) * u, a.elevation + (b.elevation - a.elevation) * u,
+                 a.distance + (b.distance - a.distance) * u, a.gain + (b.gain - a.gain) * u };
+    }
+};
+
+// ────────────────────────────────────────────────────────────────
+// Stems: a WAV file, or a deterministic test signal for --golden
+// ────────────────────────────────────────────────────────────────
+struct Stem {
+    std::unique_ptr<WavReader> wav;
+    int      synth    = -1;      // test signal index, −1 for WAV
+    int64_t  frames   = 0;
+    int64_t  position = 0;
+    uint32_t seed     = 0;
+    float    phase    = 0.0f;
+
+    // Volts, WAV full scale = fullScale; test signals are ≈5 V peak
+    void read(float* out, int count, float fullScale, uint32_t rate) {
+        if (wav) {
+            wav->read(out, count);
+            for (int n = 0; n < count; ++n)
+                out[n] *= fullScale;
+            return;
+        }
+        for (int n = 0; n < count; ++n, ++position) {
+            float x = 0.0f;
+            // Odd signals drop out through the middle fifth so idle
+            // skipping and its resume are covered
+            const bool gap = (synth & 1) && position * 5 >= frames * 2 && position * 5 < frames * 3;
+            if (position < frames && !gap) {
+                switch (synth % 3) {
+                case 0:     // white noise
+                    seed = seed * 1664525u + 1013904223u;
+                    x = static_cast<float>(static_cast<int32_t>(seed)) * (5.0f / 2147483648.0f);
+                    break;
+                case 1:     // sine at 110·(index + 1) Hz
+                    phase = fastReduceAngle(phase + 6.2831853f * 110.0f * (synth + 1) / rate);
+                    x = 5.0f * fastSin(phase);
+                    break;
+                default:    // 20 Hz pulse train
+                    x = (position % (rate / 20) < 8) ? 5.0f : 0.0f;
+                    break;
+                }
+            }
+            out[n] = x;
+        }
+    }
+};
+
+// ────────────────────────────────────────────────────────────────
+// Thread pool
+// ────────────────────────────────────────────────────────────────
+// Tasks may submit tasks and wait for them: a waiting thread runs
+// queued work instead of blocking, so nesting can't deadlock.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads) {
+        for (int i = 1; i < threads; ++i)
+            workers.emplace_back([this] { workerLoop(); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& t : workers)
+            t.join();
+    }
+
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+        }
+        wake.notify_one();
+    }
+
+    void wait(const std::atomic<int>& pending) {
+        while (pending.load() > 0) {
+            if (!runOne())
+                std::this_thread::yield();
+        }
+    }
+
+private:
+    bool runOne() {
+        std::function<void()> task;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (tasks.empty())
+                return false;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+        return true;
+    }
+
+    void workerLoop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (tasks.empty())
+                    return;
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex                        mutex;
+    std::condition_variable           wake;
+    std::deque<std::function<void()>> tasks;
+    std::vector<std::thread>          workers;
+    bool                              stopping = false;
+};
+
+// ────────────────────────────────────────────────────────────────
+// Plugin voices
+// ────────────────────────────────────────────────────────────────
+struct EmitterParams {
+    int azimuth, elevation, distance, gain;
+};
+
+static int findParam(const _NT_algorithm* alg, int numParameters, const char* paramName)
+{
+    for (int p = 0; p < numParameters; ++p)
+        if (strcmp(alg->parameters[p].name, paramName) == 0)
+            return p;
+    return -1;
+}
+
+static int findParam(const _NT_algorithm* alg, const char* pageName, const char* paramName)
+{
+    const _NT_parameterPages* pages = alg->parameterPages;
+    for (uint32_t i = 0; i < pages->numPages; ++i) {
+        const _NT_parameterPage& page = pages->pages[i];
+        if (strcmp(page.name, pageName) != 0)
+            continue;
+        for (int j = 0; j < page.numParams; ++j) {
+            int p = page.params[j];
+            if (strstr(alg->parameters[p].name, paramName))
+                return p;
+        }
+    }
+    return -1;
+}
+
+static bool setParam(NtHostAlgorithm& host, const char* name, int value)
+{
+    int p = findParam(host.algorithm, host.numParameters(), name);
+    if (p < 0) {
+        fprintf(stderr, "unknown parameter \"%s\"\n", name);
+        return false;
+    }
+    host.setParameter(p, static_cast<int16_t>(value));
+    return true;
+}
+
+// One plugin instance rendering emitters first…first + count − 1 of a
+// job into its own stereo chunk buffer
+struct Voice {
+    NtHostAlgorithm            host;
+    int                        first = 0, count = 0;
+    std::vector<EmitterParams> params;
+    std::vector<float>         bus;
+    std::vector<float>         outL, outR;
+
+    bool create(const RenderOptions& o, int first_, int count_) {
+        first = first_;
+        count = count_;
+        const _NT_factory*   factory = NT_hostFactory();
+        std::vector<int32_t> specs(factory->numSpecifications);
+        for (uint32_t i = 0; i < factory->numSpecifications; ++i) {
+            specs[i] = factory->specifications[i].def;
+            for (const auto& ov : o.specOverrides)
+                if (ov.first == factory->specifications[i].name)
+                    specs[i] = ov.second;
+        }
+        specs[0] = count;
+        if (!host.create(factory, specs.data())) {
+            fprintf(stderr, "construct failed\n");
+            return false;
+        }
+
+        bool ok = true;
+        for (const auto& ov : o.paramOverrides)
+            ok &= setParam(host, ov.first.c_str(), ov.second);
+        ok &= setParam(host, "Output L", kOutputBusL);
+        ok &= setParam(host, "Output R", kOutputBusR);
+        ok &= setParam(host, "Output L mode", 1);      // Replace
+
+        params.resize(count);
+        for (int e = 0; e < count; ++e) {
+            char page[24];
+            snprintf(page, sizeof(page), "Emitter %d", e + 1);
+            host.setParameter(findParam(host.algorithm, page, "Input"), static_cast<int16_t>(1 + e));
+            params[e] = { findParam(host.algorithm, page, "Azimuth"), findParam(host.algorithm, page, "Elevation"),
+                          findParam(host.algorithm, page, "Distance"), findParam(host.algorithm, page, "Gain") };
+        }
+
+        bus.assign(static_cast<size_t>(kNtHostNumBusses) * o.block, 0.0f);
+        outL.resize(o.chunk);
+        outR.resize(o.chunk);
+        return ok;
+    }
+
+    int param(const char* name) {
+        int p = findParam(host.algorithm, host.numParameters(), name);
+        return (p < 0) ? 0 : host.parameter(p);
+    }
+
+    // frames is a whole number of blocks starting at frame start
+    void render(const RenderOptions& o, const Trajectory& traj, const std::vector<std::vector<float>>& inputs,
+                int64_t start, int frames, uint32_t rate) {
+        for (int off = 0; off < frames; off += o.block) {
+            const double t = static_cast<double>(start + off) / rate;
+            for (int e = 0; e < count; ++e) {
+                Key   k  = traj.at(first + e, t);
+                float az = k.azimuth - 360.0f * floorf((k.azimuth + 180.0f) / 360.0f);
+                host.setParameter(params[e].azimuth, static_cast<int16_t>(lrintf(az)));
+                host.setParameter(params[e].elevation, static_cast<int16_t>(lrintf(k.elevation)));
+                host.setParameter(params[e].distance, static_cast<int16_t>(lrintf(k.distance * 10.0f)));
+                host.setParameter(params[e].gain, static_cast<int16_t>(lrintf(k.gain)));
+                memcpy(bus.data() + e * o.block, inputs[first + e].data() + off, o.block * sizeof(float));
+            }
+            host.step(bus.data(), o.block / 4);
+            memcpy(outL.data() + off, bus.data() + (kOutputBusL - 1) * o.block, o.block * sizeof(float));
+            memcpy(outR.data() + off, bus.data() + (kOutputBusR - 1) * o.block, o.block * sizeof(float));
+        }
+    }
+};
+
+// ────────────────────────────────────────────────────────────────
+// Jobs
+// ────────────────────────────────────────────────────────────────
+struct Job {
+    std::string              output;        // empty: hash only
+    std::string              trajectoryPath;
+    std::vector<std::string> stems;
+    int                      synthStems = 0;
+    double                   synthSeconds = 0.0;
+    Trajectory               trajectory;    // synthetic scenes fill this directly
+    uint64_t                 hash = 0;
+    int64_t                  frames = 0;    // rendered, tail included
+    bool                     keep = false;  // collect the output in mix
+    std::vector<float>       mix;           // interleaved, when keep
+    bool                     ok = false;
+};
+
+constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime  = 1099511628211ull;
+
+static uint64_t hashSamples(uint64_t h, const float* left, const float* right, int count)
+{
+    for (int n = 0; n < count; ++n) {
+        for (float x : { left[n], right[n] }) {
+            uint32_t bits;
+            memcpy(&bits, &x, 4);
+            for (int b = 0; b < 4; ++b)
+                h = (h ^ ((bits >> (8 * b)) & 0xff)) * kFnvPrime;
+        }
+    }
+    return h;
+}
+
+static int numEmitters(const Job& job)
+{
+    return job.synthStems ? job.synthStems : static_cast<int>(job.stems.size());
+}
+
+// Opens a job's stems; frames is the longest stem
+static bool openStems(const Job& job, std::vector<Stem>& stems, uint32_t rate, int64_t& frames)
+{
+    stems.resize(numEmitters(job));
+    frames = 0;
+    for (size_t e = 0; e < stems.size(); ++e) {
+        Stem& s = stems[e];
+        if (job.synthStems) {
+            s.synth  = static_cast<int>(e);
+            s.frames = static_cast<int64_t>(job.synthSeconds * rate);
+            s.seed   = 0x9e3779b9u * static_cast<uint32_t>(e + 1);
+        } else {
+            s.wav.reset(new WavReader);
+            if (!s.wav->open(job.stems[e]))
+                return false;
+            if (s.wav->rate != rate) {
+                fprintf(stderr, "%s: %u Hz, expected %u Hz\n", job.stems[e].c_str(), s.wav->rate, rate);
+                return false;
+            }
+            s.frames = s.wav->frames;
+        }
+        frames = std::max(frames, s.frames);
+    }
+    return true;
+}
+
+// True when every emitter renders independently of the others, so a
+// plugin instance per emitter gives the same output as one for all.
+// Speakers sharing an output bus add up per emitter, which a split
+// render would reassociate.
+static bool separable(Voice& probe, int emitters)
+{
+    const bool ambisonic = probe.param("Render mode") == 2;
+    const bool speakers  = probe.param("Render mode") == 3;
+    const bool lanes     = probe.param("Render mode") == 0 && probe.param("Engine") == 1;
+    const bool reverb    = probe.param("Reverb") > -40;
+    const bool cv        = probe.param("Azimuth CV") || probe.param("Elevation CV") || probe.param("Distance CV");
+    return !ambisonic && !speakers && !lanes && !reverb && !cv && probe.param("Auto Spread") == 0 &&
+           probe.param("CPU budget") >= emitters;
+}
+
+// Streams one job through.  split renders a plugin instance per emitter
+// on the pool when the scene allows it; otherwise (and for --check's
+// reference) one instance renders every emitter on this thread.
+static bool renderJob(Job& job, const RenderOptions& o, uint32_t rate, ThreadPool& pool, bool split,
+                      uint64_t& hash, int64_t& rendered)
+{
+    std::vector<Stem> stems;
+    int64_t           stemFrames = 0;
+    if (!openStems(job, stems, rate, stemFrames))
+        return false;
+    const int emitters = static_cast<int>(stems.size());
+
+    // A one-emitter probe decides; it becomes emitter 0's voice
+    std::vector<std::unique_ptr<Voice>> voices;
+    voices.emplace_back(new Voice);
+    if (!voices[0]->create(o, 0, 1))
+        return false;
+    if (split && separable(*voices[0], emitters)) {
+        for (int e = 1; e < emitters; ++e) {
+            voices.emplace_back(new Voice);
+            if (!voices[e]->create(o, e, 1))
+                return false;
+        }
+    } else {
+        if (emitters > kMaxCombinedEmitters) {
+            fprintf(stderr, "%d stems: at most %d when emitters render in one instance\n",
+                    emitters, kMaxCombinedEmitters);
+            return false;
+        }
+        voices[0].reset(new Voice);
+        if (!voices[0]->create(o, 0, emitters))
+            return false;
+    }
+
+    WavWriter writer;
+    if (!job.output.empty() && !writer.open(job.output, rate, o.format))
+        return false;
+
+    const int64_t total = (stemFrames + static_cast<int64_t>(o.tail * rate) + o.block - 1) / o.block * o.block;
+    std::vector<std::vector<float>> inputs(emitters, std::vector<float>(o.chunk));
+    std::vector<float> mixL(o.chunk), mixR(o.chunk);
+    hash = kFnvOffset;
+    rendered = total;
+
+    for (int64_t start = 0; start < total; start += o.chunk) {
+        const int frames = static_cast<int>(std::min<int64_t>(o.chunk, total - start));
+        for (int e = 0; e < emitters; ++e)
+            stems[e].read(inputs[e].data(), frames, o.fullScale, rate);
+
+        if (voices.size() > 1) {
+            std::atomic<int> pending(static_cast<int>(voices.size()));
+            for (auto& v : voices) {
+                Voice* voice = v.get();
+                pool.submit([&, voice] {
+                    voice->render(o, job.trajectory, inputs, start, frames, rate);
+                    pending.fetch_sub(1);
+                });
+            }
+            pool.wait(pending);
+        } else {
+            voices[0]->render(o, job.trajectory, inputs, start, frames, rate);
+        }
+
+        // Emitter order, as step() accumulates; + 0 turns −0 into +0,
+        // the one bit an idle leading emitter could otherwise change
+        for (int n = 0; n < frames; ++n) {
+            float l = voices[0]->outL[n], r = voices[0]->outR[n];
+            for (size_t v = 1; v < voices.size(); ++v) {
+                l += voices[v]->outL[n];
+                r += voices[v]->outR[n];
+            }
+            mixL[n] = l + 0.0f;
+            mixR[n] = r + 0.0f;
+        }
+        hash = hashSamples(hash, mixL.data(), mixR.data(), frames);
+        if (job.keep) {
+            for (int n = 0; n < frames; ++n) {
+                job.mix.push_back(mixL[n]);
+                job.mix.push_back(mixR[n]);
+            }
+        }
+        if (writer.file)
+            writer.write(mixL.data(), mixR.data(), frames, 1.0f / o.fullScale);
+    }
+    return true;
+}
+
+static void runJob(Job& job, const RenderOptions& o, uint32_t rate, ThreadPool& pool)
+{
+    job.ok = job.trajectory.emitters.size() == static_cast<size_t>(numEmitters(job)) ||
+             job.trajectory.load(job.trajectoryPath, numEmitters(job));
+    job.ok = job.ok && renderJob(job, o, rate, pool, true, job.hash, job.frames);
+    if (job.ok && o.check) {
+        uint64_t reference = 0;
+        int64_t  frames = 0;
+        Job      plain = job;
+        plain.output.clear();
+        plain.keep = false;
+        job.ok = renderJob(plain, o, rate, pool, false, reference, frames);
+        if (job.ok && reference != job.hash) {
+            fprintf(stderr, "%s: split render differs from the single-instance render\n",
+                    job.output.empty() ? "scene" : job.output.c_str());
+            job.ok = false;
+        }
+    }
+}
+
+// Runs every job on the pool; false if any failed
+static bool runJobs(std::vector<Job>& jobs, const RenderOptions& o, uint32_t rate)
+{
+    NT_hostSetSampleRate(rate);
+    NT_hostSetMaxFramesPerStep(static_cast<uint32_t>(o.block));
+
+    int threads = o.threads ? o.threads : static_cast<int>(std::thread::hardware_concurrency());
+    ThreadPool pool(std::max(1, threads));
+    std::atomic<int> pending(static_cast<int>(jobs.size()));
+    for (Job& job : jobs) {
+        Job* j = &job;
+        pool.submit([&, j] {
+            runJob(*j, o, rate, pool);
+            pending.fetch_sub(1);
+        });
+    }
+    pool.wait(pending);
+
+    bool ok = true;
+    for (const Job& job : jobs)
+        ok &= job.ok;
+    return ok;
+}
+
+// ────────────────────────────────────────────────────────────────
+// Golden scenes
+// ────────────────────────────────────────────────────────────────
+struct GoldenScene {
+    const char* name;
+    const char* params[5];      // NAME=VALUE
+    const char* specs[1];       // NAME=VALUE
+};
+
+const GoldenScene kGoldenScenes[] = {
+    { "parametric", {} },
+    { "lagrange",   { "Delay interp=1" } },
+    { "thiran",     { "Delay interp=2" } },
+    { "lod",        { "CPU budget=2" } },
+    { "lanes",      { "Engine=1" } },
+    { "hrir",       { "Render mode=1" } },
+    { "ambisonic",  { "Render mode=2" } },
+    { "reverb",     { "Reverb=-12", "Reverb time=20" } },
+    { "svf",        { "Filter=1" } },
+    { "cv",         { "Azimuth CV=5", "Distance CV=4", "CV interval=8" }, { "CV inputs=1" } },
+    { "speakers",   { "Render mode=3", "Speaker 1=27", "Speaker 2=28", "Speaker 3=28", "Speaker 4=27" },
+                    { "Speakers=4" } },
+    { "head",       { "Head yaw=60", "Head pitch=20", "Head roll=-15" } },
+    { "nonotch",    { "Quality=1", "Filter=1" } },
+    { "direct",     { "Quality=3" } },
+};
+
+constexpr int    kGoldenEmitters = 5;
+constexpr double kGoldenSeconds  = 1.5;
+
+// Emitters orbit in opposite directions while rising and receding; the
+// last one fades to the −60 dB floor and back
+static Job goldenJob()
+{
+    Job job;
+    job.synthStems   = kGoldenEmitters;
+    job.synthSeconds = kGoldenSeconds;
+    job.trajectory.emitters.resize(kGoldenEmitters);
+    for (int e = 0; e < kGoldenEmitters; ++e) {
+        const float az  = -180.0f + 360.0f * e / kGoldenEmitters;
+        const float dir = (e & 1) ? -1.0f : 1.0f;
+        auto& keys = job.trajectory.emitters[e];
+        keys.push_back({ 0.0, az, -20.0f, 0.5f + e, 0.0f });
+        keys.push_back({ kGoldenSeconds / 2, az + dir * 180.0f, 40.0f, 1.0f, e == kGoldenEmitters - 1 ? -60.0f : 0.0f });
+        keys.push_back({ kGoldenSeconds, az + dir * 360.0f, 0.0f, 6.0f, 0.0f });
+    }
+    return job;
+}
+
+// Block-size invariance: emitters jump between held positions (up,
+// down through the floor plane, near and far) on 128-frame boundaries,
+// so every block size sees the same targets.  Rendered at the default
+// Quality, each block size must match the 8-frame render to within
+// kBlockLimitDb of the peak; what remains is the per-block glide
+// segments, which the kernels ramp linearly.
+const GoldenScene kBlockScenes[] = {
+    { "parametric", {} },
+    { "lanes",      { "Engine=1" } },
+};
+
+const int        kBlockSizes[]    = { 8, 32, 128 };
+constexpr double kBlockSeconds    = 1.0;
+constexpr double kBlockJump       = 128.0 * 100 / 48000; // s between jumps, on every block boundary
+constexpr float  kBlockLimitDb    = -40.0f;
+
+static Job blockJob()
+{
+    static const float kStops[2][4][3] = {
+        { { 30.0f, 10.0f, 1.0f }, { 90.0f, 40.0f, 3.0f }, { -120.0f, -10.0f, 1.5f }, { -60.0f, 5.0f, 8.0f } },
+        { { -45.0f, 0.0f, 2.0f }, { 170.0f, -30.0f, 0.5f }, { 100.0f, 60.0f, 6.0f }, { 0.0f, 0.0f, 1.0f } },
+    };
+    Job job;
+    job.synthStems   = 2;
+    job.synthSeconds = kBlockSeconds;
+    job.keep         = true;
+    job.trajectory.emitters.resize(2);
+    for (int e = 0; e < 2; ++e) {
+        auto& keys = job.trajectory.emitters[e];
+        for (int i = 0; i < 4; ++i) {
+            const float* p    = kStops[e][i];
+            const double jump = kBlockJump * i;
+            if (i)
+                keys.push_back({ jump - 1.0e-4, kStops[e][i - 1][0], kStops[e][i - 1][1], kStops[e][i - 1][2], 0.0f });
+            keys.push_back({ jump, p[0], p[1], p[2], 0.0f });
+        }
+    }
+    return job;
+}
+
+static void sceneOverrides(const GoldenScene& scene, RenderOptions& so)
+{
+    for (const char* p : scene.params) {
+        if (!p)
+            continue;
+        const char* eq = strchr(p, '=');
+        so.paramOverrides.push_back({ std::string(p, eq), atoi(eq + 1) });
+    }
+    for (const char* p : scene.specs) {
+        if (!p)
+            continue;
+        const char* eq = strchr(p, '=');
+        so.specOverrides.push_back({ std::string(p, eq), atoi(eq + 1) });
+    }
+}
+
+// Prints one line per scene and block size; false past kBlockLimitDb
+static bool runBlockInvariance(const RenderOptions& o, uint32_t rate)
+{
+    bool ok = true;
+    for (const GoldenScene& scene : kBlockScenes) {
+        std::vector<float> reference;
+        for (int block : kBlockSizes) {
+            RenderOptions so = o;
+            so.block = block;
+            sceneOverrides(scene, so);
+            std::vector<Job> jobs(1, blockJob());
+            if (!runJobs(jobs, so, rate)) {
+                fprintf(stderr, "block scene %s failed to render\n", scene.name);
+                return false;
+            }
+            std::vector<float>& mix = jobs[0].mix;
+            if (reference.empty()) {
+                reference.swap(mix);
+                continue;
+            }
+            float peak = 0.0f, diff = 0.0f;
+            const size_t count = std::min(mix.size(), reference.size());
+            for (size_t n = 0; n < count; ++n) {
+                peak = std::max(peak, fabsf(reference[n]));
+                diff = std::max(diff, fabsf(mix[n] - reference[n]));
+            }
+            const float db   = 20.0f * log10f(std::max(diff, 1.0e-30f) / std::max(peak, 1.0e-30f));
+            const bool  pass = db <= kBlockLimitDb;
+            ok &= pass;
+            printf("%-12s block %3d vs %d  %6.1f dB  %s\n", scene.name, block, kBlockSizes[0], db,
+                   pass ? "ok" : "DIFFERS");
+        }
+    }
+    return ok;
+}
+
+static int runGolden(const std::string& path, bool update, RenderOptions o)
+{
+    const uint32_t rate = 48000;
+    std::vector<std::string> lines;
+    bool ok = true;
+    for (const GoldenScene& scene : kGoldenScenes) {
+        RenderOptions so = o;
+        so.check = true;
+        sceneOverrides(scene, so);
+        std::vector<Job> jobs(1, goldenJob());
+        if (!runJobs(jobs, so, rate)) {
+            fprintf(stderr, "golden scene %s failed to render\n", scene.name);
+            return 2;
+        }
+        char line[64];
+        snprintf(line, sizeof(line), "%-12s %016llx", scene.name, static_cast<unsigned long long>(jobs[0].hash));
+        lines.push_back(line);
+    }
+
+    if (update) {
+        FILE* f = fopen(path.c_str(), "w");
+        if (!f) {
+            fprintf(stderr, "%s: cannot write\n", path.c_str());
+            return 2;
+        }
+        fprintf(f, "# tinear_render --golden: scene and FNV-1a hash of the float output\n");
+        for (const std::string& l : lines)
+            fprintf(f, "%s\n", l.c_str());
+        fclose(f);
+        printf("wrote %zu golden hashes to %s\n", lines.size(), path.c_str());
+        return 0;
+    }
+
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) {
+        fprintf(stderr, "%s: cannot open (create it with --update)\n", path.c_str());
+        return 2;
+    }
+    std::vector<std::string> expected;
+    char buf[128];
+    while (fgets(buf, sizeof(buf), f)) {
+        if (buf[0] == '#')
+            continue;
+        buf[strcspn(buf, "\r\n")] = 0;
+        expected.push_back(buf);
+    }
+    fclose(f);
+
+    for (size_t i = 0; i < lines.size(); ++i) {
+        bool match = i < expected.size() && expected[i] == lines[i];
+        ok &= match;
+        printf("%s  %s\n", lines[i].c_str(), match ? "ok" : "CHANGED");
+    }
+    ok &= expected.size() == lines.size();
+    ok &= runBlockInvariance(o, rate);
+    return ok ? 0 : 1;
+}
+
+// ────────────────────────────────────────────────────────────────
+// Command line
+// ────────────────────────────────────────────────────────────────
+static bool readBatch(const std::string& path, std::vector<Job>& jobs)
+{
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) {
+        fprintf(stderr, "%s: cannot open\n", path.c_str());
+        return false;
+    }
+    char line[4096];
+    while (fgets(line, sizeof(line), f)) {
+        char* hash = strchr(line, '#');
+        if (hash)
+            *hash = 0;
+        std::vector<std::string> words;
+        for (char* w = strtok(line, " \t\r\n"); w; w = strtok(nullptr, " \t\r\n"))
+            words.push_back(w);
+        if (words.empty())
+            continue;
+        if (words.size() < 3) {
+            fprintf(stderr, "%s: expected OUT.wav TRAJECTORY|- STEM.wav…\n", path.c_str());
+            fclose(f);
+            return false;
+        }
+        Job job;
+        job.output         = words[0];
+        job.trajectoryPath = words[1];
+        job.stems.assign(words.begin() + 2, words.end());
+        jobs.push_back(std::move(job));
+    }
+    fclose(f);
+    return true;
+}
+
+static void usage(const char* argv0)
+{
+    fprintf(stderr,
+            "usage: %s [options] -o OUT.wav [-t TRAJECTORY] STEM.wav...\n"
+            "       %s [options] --batch JOBS.txt\n"
+            "       %s [options] --golden LIST [--update]\n"
+            "options: [--block N] [--chunk N] [--threads N] [--tail S]\n"
+            "         [--format f32|s16|s24] [--full-scale V]\n"
+            "         [--spec NAME=VALUE] [--param NAME=VALUE] [--hash] [--check]\n",
+            argv0, argv0, argv0);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    RenderOptions o;
+    Job           single;
+    std::string   batchPath, goldenPath;
+    bool          update = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) { usage(argv[0]); exit(2); }
+            return argv[++i];
+        };
+        if (a == "-o")                  single.output = next();
+        else if (a == "-t")             single.trajectoryPath = next();
+        else if (a == "--batch")        batchPath = next();
+        else if (a == "--golden")       goldenPath = next();
+        else if (a == "--update")       update = true;
+        else if (a == "--block")        o.block = std::max(4, atoi(next()) / 4 * 4);
+        else if (a == "--chunk")        o.chunk = atoi(next());
+        else if (a == "--threads")      o.threads = std::max(0, atoi(next()));
+        else if (a == "--tail")         o.tail = std::max(0.0, atof(next()));
+        else if (a == "--full-scale")   o.fullScale = static_cast<float>(atof(next()));
+        else if (a == "--hash")         o.hash = true;
+        else if (a == "--check")        o.check = true;
+        else if (a == "--format") {
+            std::string f = next();
+            if (f == "f32")      o.format = 0;
+            else if (f == "s16") o.format = 1;
+            else if (f == "s24") o.format = 2;
+            else { usage(argv[0]); return 2; }
+        }
+        else if (a == "--spec" || a == "--param") {
+            std::string kv = next();
+            size_t      eq = kv.find('=');
+            if (eq == std::string::npos) { usage(argv[0]); return 2; }
+            auto& list = (a == "--spec") ? o.specOverrides : o.paramOverrides;
+            list.push_back({ kv.substr(0, eq), atoi(kv.c_str() + eq + 1) });
+        }
+        else if (!a.empty() && a[0] != '-') single.stems.push_back(a);
+        else { usage(argv[0]); return 2; }
+    }
+    // Chunks hold whole blocks
+    o.chunk = std::max(o.block, o.chunk / o.block * o.block);
+
+#if defined(__SSE__)
+    // Flush-to-zero, as on the Cortex-M7
+    _mm_setcsr(_mm_getcsr() | 0x8040);
+#endif
+
+    if (!goldenPath.empty())
+        return runGolden(goldenPath, update, o);
+
+    std::vector<Job> jobs;
+    if (!batchPath.empty()) {
+        if (!readBatch(batchPath, jobs))
+            return 2;
+    } else if (!single.output.empty() && !single.stems.empty()) {
+        jobs.push_back(std::move(single));
+    }
+    if (jobs.empty()) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // NT_globals.sampleRate is global, so a batch shares one rate
+    WavReader probe;
+    if (!probe.open(jobs[0].stems[0]))
+        return 2;
+    const uint32_t rate = probe.rate;
+
+    auto t0 = std::chrono::steady_clock::now();
+    bool ok = runJobs(jobs, o, rate);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    double audio = 0.0;
+    for (const Job& job : jobs) {
+        if (!job.ok)
+            continue;
+        audio += static_cast<double>(job.frames) / rate;
+        if (o.hash)
+            printf("%016llx  %s\n", static_cast<unsigned long long>(job.hash), job.output.c_str());
+    }
+    printf("rendered %.1f s of audio in %.2f s (%.1f× real time)\n", audio, seconds,
+           seconds > 0.0 ? audio / seconds : 0.0);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,267 @@
+// Loudspeaker-array render mode – see vbap.h
+
+#include "vbap.h"
+
+// ────────────────────────────────────────────────────────────────
+// Layout
+// ────────────────────────────────────────────────────────────────
+// Single rings (every elevation within this of the others) pan in 2D
+constexpr float kVbapRingTolerance = 1.0f;      // degrees
+constexpr float kVbapMinDet        = 1.0e-3f;
+constexpr float kVbapValidGain     = -1.0e-5f;
+
+bool VbapLayout::build(const float* azimuthDeg, const float* elevationDeg, int n)
+{
+    count    = (n < 0) ? 0 : (n > kVbapMaxSpeakers) ? kVbapMaxSpeakers : n;
+    numBases = 0;
+    dims     = 2;
+
+    float (*u)[3] = dir;
+    float az[kVbapMaxSpeakers];
+    for (int s = 0; s < count; ++s) {
+        const float a = azimuthDeg[s] * (M_PI / 180.0f);
+        const float e = elevationDeg[s] * (M_PI / 180.0f);
+        u[s][0] = fastCos(e) * fastSin(a);
+        u[s][1] = fastSin(e);
+        u[s][2] = fastCos(e) * fastCos(a);
+        az[s]   = azimuthDeg[s] - 360.0f * floorf(azimuthDeg[s] / 360.0f);     // 0…360
+        if (fabsf(elevationDeg[s] - elevationDeg[0]) > kVbapRingTolerance)
+            dims = 3;
+    }
+
+    if (dims == 2) {
+        // Speakers in azimuth order; each with the next round the ring
+        int order[kVbapMaxSpeakers];
+        for (int s = 0; s < count; ++s) {
+            int i = s;
+            for (; i > 0 && az[order[i - 1]] > az[s]; --i)
+                order[i] = order[i - 1];
+            order[i] = s;
+        }
+        for (int i = 0; i < count && count > 1; ++i) {
+            const int a = order[i], b = order[(i + 1) % count];
+            float gap = az[b] - az[a];
+            if (gap <= 0.0f)
+                gap += 360.0f;
+            if (gap >= 179.9f)
+                continue;
+
+            // Horizontal components, L = [[xa, za], [xb, zb]]
+            const float xa = u[a][0], za = u[a][2], xb = u[b][0], zb = u[b][2];
+            const float det = xa * zb - za * xb;
+            if (fabsf(det) < kVbapMinDet)
+                continue;
+            float* inv = inverse[numBases];
+            inv[0] =  zb / det;  inv[1] = -za / det;
+            inv[2] = -xb / det;  inv[3] =  xa / det;
+            speaker[numBases][0] = static_cast<int8_t>(a);
+            speaker[numBases][1] = static_cast<int8_t>(b);
+            speaker[numBases][2] = -1;
+            ++numBases;
+        }
+        return numBases > 0;
+    }
+
+    // Convex hull faces: every other speaker on the inner side of the
+    // triangle's plane, which must not pass through the listener
+    for (int i = 0; i < count; ++i)
+    for (int j = i + 1; j < count; ++j)
+    for (int k = j + 1; k < count; ++k) {
+        const float* a = u[i];
+        const float* b = u[j];
+        const float* c = u[k];
+        // Adjugate of L = [a; b; c] (rows), so L⁻¹ = adj / det
+        float adj[9] = {
+            b[1] * c[2] - b[2] * c[1], a[2] * c[1] - a[1] * c[2], a[1] * b[2] - a[2] * b[1],
+            b[2] * c[0] - b[0] * c[2], a[0] * c[2] - a[2] * c[0], a[2] * b[0] - a[0] * b[2],
+            b[0] * c[1] - b[1] * c[0], a[1] * c[0] - a[0] * c[1], a[0] * b[1] - a[1] * b[0],
+        };
+        const float det = a[0] * adj[0] + a[1] * adj[3] + a[2] * adj[6];
+        if (fabsf(det) < kVbapMinDet)
+            continue;
+
+        float nrm[3] = {
+            (b[1] - a[1]) * (c[2] - a[2]) - (b[2] - a[2]) * (c[1] - a[1]),
+            (b[2] - a[2]) * (c[0] - a[0]) - (b[0] - a[0]) * (c[2] - a[2]),
+            (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]),
+        };
+        float out = nrm[0] * a[0] + nrm[1] * a[1] + nrm[2] * a[2];
+        if (out < 0.0f) {
+            nrm[0] = -nrm[0]; nrm[1] = -nrm[1]; nrm[2] = -nrm[2];
+            out = -out;
+        }
+        bool face = out > 1.0e-4f;
+        for (int m = 0; m < count && face; ++m) {
+            if (m == i || m == j || m == k)
+                continue;
+            face = nrm[0] * (u[m][0] - a[0]) + nrm[1] * (u[m][1] - a[1]) + nrm[2] * (u[m][2] - a[2]) <= 1.0e-4f;
+        }
+        if (!face)
+            continue;
+
+        float* inv = inverse[numBases];
+        for (int e = 0; e < 9; ++e)
+            inv[e] = adj[e] / det;
+        speaker[numBases][0] = static_cast<int8_t>(i);
+        speaker[numBases][1] = static_cast<int8_t>(j);
+        speaker[numBases][2] = static_cast<int8_t>(k);
+        ++numBases;
+    }
+    return numBases > 0;
+}
+
+// Gains of base b for p (row vector times L⁻¹); returns the smallest
+static inline float baseGains(const VbapLayout& l, int b, const float* p, float* g)
+{
+    const float* inv = l.inverse[b];
+    if (l.dims == 2) {
+        g[0] = p[0] * inv[0] + p[2] * inv[2];
+        g[1] = p[0] * inv[1] + p[2] * inv[3];
+        g[2] = 0.0f;
+        return (g[0] < g[1]) ? g[0] : g[1];
+    }
+    g[0] = p[0] * inv[0] + p[1] * inv[3] + p[2] * inv[6];
+    g[1] = p[0] * inv[1] + p[1] * inv[4] + p[2] * inv[7];
+    g[2] = p[0] * inv[2] + p[1] * inv[5] + p[2] * inv[8];
+    float m = (g[0] < g[1]) ? g[0] : g[1];
+    return (m < g[2]) ? m : g[2];
+}
+
+void VbapLayout::gains(float x, float y, float z, int& base, float* g) const
+{
+    for (int s = 0; s < count; ++s)
+        g[s] = 0.0f;
+    if (count == 0)
+        return;
+
+    const float p[3] = { x, y, z };
+    float       gb[3] = {};
+    int         used = -1;
+    if (numBases > 0) {
+        // The previous base first: a moving source usually stays in it
+        int   first = (base >= 0 && base < numBases) ? base : 0;
+        float best  = baseGains(*this, first, p, gb);
+        used = first;
+        for (int b = 0; b < numBases && best < kVbapValidGain; ++b) {
+            float t[3];
+            float m = baseGains(*this, b, p, t);
+            if (m > best) {
+                best = m;
+                used = b;
+                gb[0] = t[0]; gb[1] = t[1]; gb[2] = t[2];
+            }
+        }
+        base = used;
+    }
+
+    float power = 0.0f;
+    if (used >= 0) {
+        for (int k = 0; k < dims; ++k) {
+            const float v = (gb[k] > 0.0f) ? gb[k] : 0.0f;
+            g[speaker[used][k]] = v;
+            power += v * v;
+        }
+    } else {
+        // No base (one speaker, or two facing each other): the nearest
+        int   nearest = 0;
+        float best    = -1.0e30f;
+        for (int s = 0; s < count; ++s) {
+            const float d = x * dir[s][0] + y * dir[s][1] + z * dir[s][2];
+            if (d > best) {
+                best    = d;
+                nearest = s;
+            }
+        }
+        g[nearest] = 1.0f;
+        power      = 1.0f;
+    }
+
+    // A source at the listener spreads evenly
+    if (power < 1.0e-12f) {
+        const float even = 1.0f / fastSqrt(static_cast<float>(count));
+        for (int s = 0; s < count; ++s)
+            g[s] = even;
+        return;
+    }
+    const float norm = 1.0f / fastSqrt(power);
+    for (int s = 0; s < count; ++s)
+        g[s] *= norm;
+}
+
+// ────────────────────────────────────────────────────────────────
+// Emitter chain
+// ────────────────────────────────────────────────────────────────
+// The mono chain runs into a stack buffer of kSpeakerChunk samples,
+// then one ramped multiply-add pass per speaker
+constexpr int kSpeakerChunk = 64;
+
+void applyMonoSpeakerMix(const float* in,
+                         float* const* outs,
+                         int    count,
+                         int    numSamples,
+                         float  srcY,
+                         float  dist,
+                         const float* gainStart,
+                         const float* gainEnd,
+                         SpatialAudioState* state)
+{
+    if (numSamples <= 0)
+        return;
+
+    // ── 1. Block targets ────────────────────────────────────────
+    const SpatialRate& rate = *state->rate;
+    DelayBuffer& refl    = state->reflHistory;
+    const bool   reflect = refl.bound();
+    float reflDelay = state->prevReflDelay;
+    float reflStep  = (reflectionDelay(srcY, rate) - reflDelay) / numSamples;
+    const float reflScale = 0.501187f;                      // −6 dB
+    float airDist     = state->prevDist;
+    float airDistStep = (dist - airDist) / numSamples;
+    int   phase       = state->controlPhase;
+
+    float gain[kVbapMaxSpeakers], step[kVbapMaxSpeakers];
+    for (int s = 0; s < count; ++s) {
+        gain[s] = gainStart[s];
+        step[s] = (gainEnd[s] - gainStart[s]) / numSamples;
+    }
+
+    // ── 2. Mono chain, then the speaker ramps ───────────────────
+    float mono[kSpeakerChunk];
+    for (int start = 0; start < numSamples; start += kSpeakerChunk) {
+        const int n = (numSamples - start < kSpeakerChunk) ? numSamples - start : kSpeakerChunk;
+        const float* src = in + start;
+        for (int i = 0; i < n; ++i) {
+            float x     = src[i];
+            float xRefl = 0.0f;
+            state->history.write(x);
+            reflDelay += reflStep;
+            airDist   += airDistStep;
+            if (reflect) {
+                // Linear tap, no bulk delay (as in applyMonoHrirMix)
+                refl.write(x);
+                xRefl = refl.read<kInterpLinear>(state->reflTapL,
+                                                 refl.position<kInterpLinear>(fabsf(reflDelay)), -1) * reflScale;
+            }
+            if (phase == 0)
+                state->airL.setCutoff(airCutoff(airDist), rate);
+            phase = (phase + 1) & (kControlInterval - 1);
+            mono[i] = state->airL.process(x + xRefl);
+        }
+
+        for (int s = 0; s < count; ++s) {
+            if (gain[s] == 0.0f && step[s] == 0.0f)
+                continue;
+            float* dst = outs[s] + start;
+            float  g   = gain[s];
+            for (int i = 0; i < n; ++i) {
+                g += step[s];
+                dst[i] += mono[i] * g;
+            }
+            gain[s] = g;
+        }
+    }
+
+    state->prevDist = dist;
+    state->prevReflDelay = reflDelay;
+    state->controlPhase  = phase;
+}
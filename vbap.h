@@ -0,0 +1,59 @@
+// Loudspeaker-array render mode (vector-base amplitude panning)
+// -------------------------------------------------------------------
+// • Each emitter is panned to the one speaker pair (horizontal layouts)
+//   or triplet (layouts with any elevated speaker) whose base contains
+//   its direction, with power-normalised gains; every other speaker
+//   gets nothing.
+// • The pairs/triplets and their inverted base matrices are built when
+//   the layout changes (parameterChanged), not per block: a lookup is
+//   one 2×2 or 3×3 multiply per candidate, starting from the emitter's
+//   previous one.
+// • Pairs are adjacent speakers in azimuth less than 180° apart;
+//   triplets are the faces of the speakers' convex hull.  A direction
+//   outside every base (beyond the ends of a frontal arc, below the
+//   lowest ring) takes the nearest one with its negative gains clipped.
+// • The emitter chain before the panner is the mono part of the
+//   parametric and HRIR paths: whole-sample floor reflection and air
+//   absorption.  Head-related cues (ITD, ILD, shelf, notch) belong to
+//   the listener's ears, not the speakers, and are skipped.
+
+#pragma once
+
+#include "professional_spatial_audio.h"
+
+constexpr int kVbapMaxSpeakers = 8;
+constexpr int kVbapMaxBases    = kVbapMaxSpeakers * (kVbapMaxSpeakers - 1) * (kVbapMaxSpeakers - 2) / 6;
+
+struct VbapLayout {
+    // Speaker directions in degrees, in the emitters' convention
+    // (azimuth > 0 left of front, elevation > 0 up); false if no
+    // speaker base could be formed, which leaves the nearest speaker
+    // taking everything
+    bool build(const float* azimuthDeg, const float* elevationDeg, int count);
+
+    // Power-normalised gains for every speaker (count entries) toward
+    // the engine-axes direction (x left, y up, z front; any length).
+    // base is the candidate tried first, updated to the one used.
+    void gains(float x, float y, float z, int& base, float* g) const;
+
+    int    count    = 0;
+    int    dims     = 0;                       // 2: pairs in the horizontal plane, 3: triplets
+    int    numBases = 0;
+    float  dir[kVbapMaxSpeakers][3] = {};      // unit directions, engine axes
+    int8_t speaker[kVbapMaxBases][3] = {};     // per base; −1 past a pair
+    float  inverse[kVbapMaxBases][9] = {};     // row-major L⁻¹, g = p · L⁻¹
+};
+
+// Adds the mono chain of one emitter into count speaker busses, each
+// gain ramping linearly from gainStart to gainEnd (speaker gain ×
+// output gain); speakers sharing a bus add up.  The input history stays
+// current for a switch back to the parametric path.
+void applyMonoSpeakerMix(const float* in,
+                         float* const* outs,
+                         int    count,
+                         int    numSamples,
+                         float  srcY,
+                         float  dist,
+                         const float* gainStart,
+                         const float* gainEnd,
+                         SpatialAudioState* state);